@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdlib>
+#include <new>
+
+// Counting replacement for the global operator new, used by SelfCheck --check-allocations
+// to prove that the spin loop does not touch the heap once warmed up. Counting is per
+// thread and only while armed. It replaces the allocator of the whole program, so only
+// the SelfCheck executable includes it (from SelfCheck.cpp); the simulator never does.
+namespace AllocationCounter {
+    thread_local bool armed = false;
+    thread_local long long count = 0;
+
+    inline void arm() { count = 0; armed = true; }
+
+    // Stops counting and returns the allocations made by this thread since arm()
+    inline long long disarm() { armed = false; return count; }
+}
+
+// GCC flags the malloc/free pairing once these are inlined into each other's callers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    if (AllocationCounter::armed) ++AllocationCounter::count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (AllocationCounter::armed) ++AllocationCounter::count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
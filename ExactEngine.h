@@ -0,0 +1,836 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <tuple>
+#include <memory>
+#include <cmath>
+#include <climits>
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+#include "GameModel.h"
+#include "Screen.h"
+
+// Weighted sums over one reel set's full cycle. Every weight is the combination's probability
+// within the cycle, so the sums are expectations once divided by totalWeight.
+struct ExactCycleResult {
+    std::string reelSetName;
+    double selectionProbability = 0.0;  // chance the base game picks this reel set
+    unsigned long long combinations = 0; // screens in the cycle; 0 when the count does not fit 64 bits
+    double totalWeight = 0.0;
+    double hitWeight = 0.0;             // weight of combinations with a win
+    double payWeight = 0.0;             // sum of weight * E[pay]
+    double paySqWeight = 0.0;           // sum of weight * E[pay^2]
+    double maxPay = 0.0;
+
+    void merge(const ExactCycleResult& other) {
+        combinations += other.combinations;
+        totalWeight += other.totalWeight;
+        hitWeight += other.hitWeight;
+        payWeight += other.payWeight;
+        paySqWeight += other.paySqWeight;
+        if (other.maxPay > maxPay) maxPay = other.maxPay;
+    }
+
+    double meanPay() const { return totalWeight > 0 ? payWeight / totalWeight : 0.0; }
+    double meanPaySq() const { return totalWeight > 0 ? paySqWeight / totalWeight : 0.0; }
+    double hitFrequency() const { return totalWeight > 0 ? hitWeight / totalWeight : 0.0; }
+};
+
+// Exact evaluation of the base game's initial screen (EXACT_MODE) over every base reel set,
+// weighted by reel weights, megaways heights and the over/under strips. Side-row boosts are
+// folded in analytically: each boosted winning side cell adds one to the multiplier, so E[pay]
+// and E[pay^2] follow from the boost probabilities. Tumbles and free spins are not part of it.
+//
+// run() works reel by reel and never builds a screen. Once the two side-strip stops are fixed
+// the reels are independent, so each reel is folded into a distribution over which paying
+// symbols are still connected, carrying the moments of their ways; a symbol's pay is settled
+// on the reel where its run ends. The cost grows with the per-reel table sizes, not with the
+// cycle. Max pay comes from a branch-and-bound search over the same tables.
+//
+// enumerate() is the screen-by-screen reference. Its cycle is the product of every reel's
+// windows and both side strips, so it refuses cycles above maxEnumeratedScreens.
+class ExactEngine {
+public:
+    static constexpr unsigned long long DEFAULT_MAX_ENUMERATED_SCREENS = 1'000'000'000ULL;
+
+    explicit ExactEngine(std::shared_ptr<const GameModel> gameModel) : model(std::move(gameModel)) {
+        boostProbOver = boostProbabilities(model->boostOverPD);
+        boostProbUnder = boostProbabilities(model->boostUnderPD);
+    }
+
+    explicit ExactEngine(std::shared_ptr<GameConfig> cfg)
+        : ExactEngine(std::make_shared<const GameModel>(*cfg)) {
+    }
+
+    // Number of combinations in the cycle of one reel set; false if it does not fit 64 bits
+    bool cycleSize(const std::string& name, unsigned long long& size) const {
+        const ReelSet& rs = model->allReelSets.at(name);
+        size = 1;
+        bool fits = true;
+        auto multiply = [&](unsigned long long factor) {
+            if (factor != 0 && size > ULLONG_MAX / factor) fits = false;
+            else size *= factor;
+        };
+        for (const auto& reelColumns : buildColumns(rs)) multiply(reelColumns.size());
+        if (rs.hasOverReel()) multiply(rs.getOverReel()->symbols.size());
+        if (rs.hasUnderReel()) multiply(rs.getUnderReel()->symbols.size());
+        return fits;
+    }
+
+    // Largest cycle enumerate() accepts
+    void setMaxEnumeratedScreens(unsigned long long limit) { maxEnumeratedScreens = limit; }
+
+    // Reel-by-reel evaluation of every base reel set the default variant can pick
+    std::vector<ExactCycleResult> run(int numThreads) {
+        return forEachBaseReelSet([&](const std::string& name) { return evaluateReelSet(name, numThreads); });
+    }
+
+    // Screen-by-screen enumeration of the same cycles. Throws before evaluating anything if a
+    // cycle is larger than maxEnumeratedScreens.
+    std::vector<ExactCycleResult> enumerate(int numThreads) {
+        const std::vector<int>& reelWeights = model->getDefaultVariant().reelWeights;
+        for (size_t id = 0; id < model->baseReelSetNames.size() && id < reelWeights.size(); ++id) {
+            if (reelWeights[id] <= 0) continue;
+            const std::string& name = model->baseReelSetNames[id];
+            unsigned long long size;
+            if (!cycleSize(name, size)) {
+                throw std::runtime_error("Cycle of " + name + " has more than 2^64 screens; use the reel-by-reel evaluation");
+            }
+            if (size > maxEnumeratedScreens) {
+                throw std::runtime_error("Cycle of " + name + " has " + std::to_string(size) + " screens, above the enumeration limit of " +
+                    std::to_string(maxEnumeratedScreens));
+            }
+        }
+        return forEachBaseReelSet([&](const std::string& name) { return enumerateReelSet(name, numThreads); });
+    }
+
+    void writeReport(const std::vector<ExactCycleResult>& results, std::ostream& out) const {
+        out << "Exact Base Game Cycle (initial screen, boosts included, no tumbles or free spins)\n";
+        out << "ReelSet\tWeight\tCombinations\tRTP\tHit Freq\tStDev\tMax Pay\n";
+
+        double mean = 0.0, meanSq = 0.0, hit = 0.0, maxPay = 0.0;
+        for (const auto& r : results) {
+            const double m = r.meanPay();
+            const double var = std::max(0.0, r.meanPaySq() - m * m);
+            out << r.reelSetName << '\t' << std::setprecision(6) << r.selectionProbability << '\t'
+                << (r.combinations ? std::to_string(r.combinations) : std::string("> 2^64")) << '\t'
+                << std::setprecision(10) << m / model->cost << '\t'
+                << r.hitFrequency() << '\t' << std::setprecision(6) << std::sqrt(var) << '\t' << r.maxPay << '\n';
+            mean += r.selectionProbability * m;
+            meanSq += r.selectionProbability * r.meanPaySq();
+            hit += r.selectionProbability * r.hitFrequency();
+            if (r.maxPay > maxPay) maxPay = r.maxPay;
+        }
+        out << "----------------------------------------\n";
+        out << "Initial RTP\t" << std::setprecision(10) << mean / model->cost << '\n';
+        out << "Hit Frequency\t" << hit << '\n';
+        out << "Variance\t" << std::setprecision(8) << std::max(0.0, meanSq - mean * mean) << '\n';
+        out << "StDev\t" << std::sqrt(std::max(0.0, meanSq - mean * mean)) << '\n';
+        out << "Max Pay\t" << maxPay << '\n';
+        out << "----------------------------------------\n";
+    }
+
+    // Base reel sets in ReelsPD outcome order (same order as GameInstance::playBaseGame)
+    const std::vector<std::string>& getBaseReelSetNames() const { return model->baseReelSetNames; }
+
+private:
+    static constexpr int SIDE_CELLS = 2 * Screen::SIDE_LEN;    // over cells, then under cells
+
+    // One visible window of a reel: its height, top stop and combined probability weight
+    struct Column {
+        int height;
+        int stop;
+        double weight;
+    };
+
+    // Every distinct window of one reel as the cells each paying symbol matches (wilds included),
+    // with its probability. The windows that no other window matches or beats on every symbol
+    // are kept apart for the max-pay search.
+    struct ReelTable {
+        std::vector<int> counts;        // numPaying per window
+        std::vector<double> probs;
+        std::vector<size_t> frontier;   // windows not dominated by another one
+        std::vector<int> maxCounts;     // per paying symbol
+    };
+
+    // Side cells for one pair of side-strip stops
+    struct SideCells {
+        std::array<uint64_t, SIDE_CELLS> matches{};     // paying symbols each cell counts for
+        std::vector<int> shift;                         // numReels x numPaying extra counts
+    };
+
+    // Reel-by-reel state: paying symbols still connected, marks on boostable side cells by
+    // settled wins, and whether any settled symbol won
+    struct FoldKey {
+        uint64_t alive;
+        std::array<uint8_t, SIDE_CELLS> marks;
+        bool hit;
+        bool operator<(const FoldKey& o) const { return std::tie(alive, marks, hit) < std::tie(o.alive, o.marks, o.hit); }
+    };
+
+    // Probability of the state, E[P] and E[P^2] of the settled pay P, and for connected symbols
+    // E[V_k], E[V_k * P] and E[V_k * V_l] of their ways so far (all restricted to the state)
+    struct FoldMoments {
+        double w = 0.0, p1 = 0.0, p2 = 0.0;
+        std::vector<double> v1, vp, vv;
+    };
+
+    using FoldStates = std::map<FoldKey, FoldMoments>;
+
+    // Paying symbols renumbered 0..numPaying-1, with the tables both evaluators read
+    struct PayingSymbols {
+        std::vector<SymbolId> ids;
+        std::vector<double> pay;        // [k * (numReels + 1) + length]
+        std::vector<uint64_t> keep;     // [r]: symbols that can still pay after surviving reel r
+        bool nonDecreasing = true;      // no symbol pays less for a longer run
+    };
+
+    std::shared_ptr<const GameModel> model;
+    std::vector<double> boostProbOver, boostProbUnder;
+    unsigned long long maxEnumeratedScreens = DEFAULT_MAX_ENUMERATED_SCREENS;
+
+    template <typename Evaluate>
+    std::vector<ExactCycleResult> forEachBaseReelSet(Evaluate evaluateOne) {
+        std::vector<ExactCycleResult> results;
+        double totalSelection = 0.0;
+        const std::vector<int>& reelWeights = model->getDefaultVariant().reelWeights;
+        for (int w : reelWeights) totalSelection += w;
+
+        for (size_t id = 0; id < model->baseReelSetNames.size() && id < reelWeights.size(); ++id) {
+            if (reelWeights[id] <= 0) continue;
+            ExactCycleResult r = evaluateOne(model->baseReelSetNames[id]);
+            r.selectionProbability = reelWeights[id] / totalSelection;
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    // Chance that each side cell is boosted (drawn a non-zero prize)
+    static std::vector<double> boostProbabilities(const std::vector<PrizeDistribution<int>>& pds) {
+        std::vector<double> probs;
+        for (const auto& pd : pds) {
+            double total = 0.0, boosted = 0.0;
+            for (size_t i = 0; i < pd.getWeights().size(); ++i) {
+                total += pd.getWeights()[i];
+                if (pd.getPrizes()[i] != 0) boosted += pd.getWeights()[i];
+            }
+            probs.push_back(total > 0 ? boosted / total : 0.0);
+        }
+        return probs;
+    }
+
+    // Boost probability of side cell c (over cells first)
+    double cellBoostProbability(int c) const {
+        const auto& probs = c < Screen::SIDE_LEN ? boostProbOver : boostProbUnder;
+        const size_t b = static_cast<size_t>(c % Screen::SIDE_LEN);
+        return b < probs.size() ? probs[b] : 0.0;
+    }
+
+    // Reel a side cell sits on; side cells only exist next to the middle reels
+    static int cellReel(int c) { return c % Screen::SIDE_LEN + 1; }
+
+    std::vector<std::vector<Column>> buildColumns(const ReelSet& rs) const {
+        std::vector<std::vector<Column>> columns(model->numReels);
+        for (int r = 0; r < model->numReels; ++r) {
+            std::vector<std::pair<int, double>> heights;
+            if (model->flags.megaways) {
+                const auto& prizes = model->reelHeightPD[r].getPrizes();
+                const auto& weights = model->reelHeightPD[r].getWeights();
+                for (size_t i = 0; i < prizes.size(); ++i)
+                    if (weights[i] > 0) heights.emplace_back(prizes[i], weights[i]);
+            }
+            else {
+                heights.emplace_back(model->symbolStructure.getWinLength(), 1.0);
+            }
+
+            const Reel& reel = rs.reels[r];
+            for (const auto& h : heights) {
+                for (int stop = 0; stop < static_cast<int>(reel.symbols.size()); ++stop) {
+                    const double stopWeight = reel.isWeighted() ? reel.weights[stop] : 1.0;
+                    if (stopWeight > 0) columns[r].push_back(Column{ h.first, stop, h.second * stopWeight });
+                }
+            }
+        }
+        return columns;
+    }
+
+    static std::vector<double> stripWeights(const Reel* reel) {
+        std::vector<double> w;
+        if (!reel) return w;
+        for (size_t i = 0; i < reel->symbols.size(); ++i) w.push_back(reel->isWeighted() ? reel->weights[i] : 1.0);
+        return w;
+    }
+
+    // --- Reel-by-reel evaluation ---
+
+    PayingSymbols payingSymbols() const {
+        PayingSymbols p;
+        const int numReels = model->numReels;
+        for (size_t id = 0; id < model->symbols.size(); ++id) {
+            bool pays = false;
+            for (int length = 1; length <= numReels; ++length) {
+                if (model->symbolStructure.getPay(static_cast<SymbolId>(id), length) > 0) pays = true;
+            }
+            if (pays) p.ids.push_back(static_cast<SymbolId>(id));
+        }
+        p.pay.assign(p.ids.size() * (numReels + 1), 0.0);
+        p.keep.assign(numReels, 0);
+        for (size_t k = 0; k < p.ids.size(); ++k) {
+            for (int length = 1; length <= numReels; ++length) {
+                const double pay = model->symbolStructure.getPay(p.ids[k], length);
+                p.pay[k * (numReels + 1) + length] = pay;
+                if (pay < p.pay[k * (numReels + 1) + length - 1]) p.nonDecreasing = false;
+                // a run that survives reel r ends at a length of r + 1 or more
+                for (int r = 0; r < length; ++r) {
+                    if (pay > 0) p.keep[r] |= 1ULL << k;
+                }
+            }
+        }
+        return p;
+    }
+
+    // Does a cell showing `id` count for paying symbol k
+    bool counts(SymbolId id, SymbolId target) const {
+        return id != EMPTY_SYMBOL && (id == target || model->symbolStructure.isWild(id));
+    }
+
+    std::vector<ReelTable> buildReelTables(const ReelSet& rs, const PayingSymbols& paying) const {
+        const size_t numPaying = paying.ids.size();
+        const auto columns = buildColumns(rs);
+        std::vector<ReelTable> tables(model->numReels);
+        for (int r = 0; r < model->numReels; ++r) {
+            const std::vector<SymbolId>& strip = rs.reels[r].ids;
+            std::map<std::vector<int>, double> windows;
+            double total = 0.0;
+            std::vector<int> n(numPaying);
+            for (const Column& c : columns[r]) {
+                std::fill(n.begin(), n.end(), 0);
+                for (int row = 0; row < c.height; ++row) {
+                    const SymbolId id = strip[(c.stop + row) % strip.size()];
+                    for (size_t k = 0; k < numPaying; ++k) n[k] += counts(id, paying.ids[k]);
+                }
+                windows[n] += c.weight;
+                total += c.weight;
+            }
+
+            ReelTable& table = tables[r];
+            table.maxCounts.assign(numPaying, 0);
+            for (const auto& w : windows) {
+                table.counts.insert(table.counts.end(), w.first.begin(), w.first.end());
+                table.probs.push_back(w.second / total);
+                for (size_t k = 0; k < numPaying; ++k) table.maxCounts[k] = std::max(table.maxCounts[k], w.first[k]);
+            }
+            const size_t numWindows = table.probs.size();
+            for (size_t i = 0; i < numWindows; ++i) {
+                bool dominated = false;
+                for (size_t j = 0; j < numWindows && !dominated; ++j) {
+                    if (i == j) continue;
+                    bool covers = true, larger = false;
+                    for (size_t k = 0; k < numPaying && covers; ++k) {
+                        const int a = table.counts[i * numPaying + k], b = table.counts[j * numPaying + k];
+                        if (b < a) covers = false;
+                        if (b > a) larger = true;
+                    }
+                    dominated = covers && larger;
+                }
+                if (!dominated) table.frontier.push_back(i);
+            }
+        }
+        return tables;
+    }
+
+    SideCells sideCells(const ReelSet& rs, const PayingSymbols& paying, size_t over, size_t under) const {
+        const size_t numPaying = paying.ids.size();
+        SideCells cells;
+        cells.shift.assign(model->numReels * numPaying, 0);
+        for (int c = 0; c < SIDE_CELLS; ++c) {
+            const bool isOver = c < Screen::SIDE_LEN;
+            const Reel* strip = isOver ? rs.getOverReel() : rs.getUnderReel();
+            const int reel = cellReel(c);
+            if (!strip || reel >= model->numReels) continue;
+            const size_t stop = isOver ? over : under;
+            const SymbolId id = strip->ids[(stop + c % Screen::SIDE_LEN) % strip->ids.size()];
+            for (size_t k = 0; k < numPaying; ++k) {
+                if (!counts(id, paying.ids[k])) continue;
+                cells.matches[c] |= 1ULL << k;
+                ++cells.shift[reel * numPaying + k];
+            }
+        }
+        return cells;
+    }
+
+    // Settles the runs of `ending` at `length`: adds their pay moments to the settled pay and
+    // their marks to the side cells. Returns the key the state moves to, without `ending`.
+    FoldKey settle(const FoldKey& key, uint64_t ending, int length, const FoldMoments& m, const PayingSymbols& paying,
+                   const SideCells& cells, const std::array<bool, SIDE_CELLS>& boostable,
+                   double& p1, double& p2, std::vector<double>& vpShift) const {
+        const size_t numPaying = paying.ids.size();
+        const size_t stride = static_cast<size_t>(model->numReels) + 1;
+        FoldKey next = key;
+        p1 = m.p1;
+        p2 = m.p2;
+        std::fill(vpShift.begin(), vpShift.end(), 0.0);
+        for (size_t d = 0; d < numPaying; ++d) {
+            if (!((ending >> d) & 1ULL)) continue;
+            const double pd = paying.pay[d * stride + length];
+            if (pd <= 0) continue;
+            next.hit = true;
+            for (int c = 0; c < SIDE_CELLS; ++c) {
+                if (boostable[c] && cellReel(c) < length && ((cells.matches[c] >> d) & 1ULL)) ++next.marks[c];
+            }
+            p1 += pd * m.v1[d];
+            p2 += 2.0 * pd * m.vp[d];
+            for (size_t e = 0; e < numPaying; ++e) {
+                if (!((ending >> e) & 1ULL)) continue;
+                p2 += pd * paying.pay[e * stride + length] * m.vv[d * numPaying + e];
+            }
+            for (size_t k = 0; k < numPaying; ++k) vpShift[k] += pd * m.vv[k * numPaying + d];
+        }
+        next.alive &= ~ending;
+        return next;
+    }
+
+    // Folds reel r into the states: a connected symbol missing from the window ends its run
+    // at length r. Windows are grouped by the connected symbols they keep, so each state is
+    // updated once per group with the group's moments of the counts.
+    void foldReel(const FoldStates& in, FoldStates& out, const ReelTable& table, const int* shift, int r,
+                  const PayingSymbols& paying, const SideCells& cells, const std::array<bool, SIDE_CELLS>& boostable) const {
+        struct Group {
+            double q = 0.0;
+            std::vector<double> q1, q2;
+        };
+        const size_t numPaying = paying.ids.size();
+        const size_t numWindows = table.probs.size();
+        std::vector<int> n(numPaying);
+        std::vector<double> vpShift(numPaying);
+
+        auto it = in.begin();
+        while (it != in.end()) {
+            const uint64_t alive = it->first.alive;
+            auto runEnd = it;
+            while (runEnd != in.end() && runEnd->first.alive == alive) ++runEnd;
+
+            if (alive == 0) {
+                for (; it != runEnd; ++it) add(out[it->first], it->second, numPaying);
+                continue;
+            }
+
+            std::map<uint64_t, Group> groups;   // by the connected symbols the window keeps
+            for (size_t j = 0; j < numWindows; ++j) {
+                uint64_t present = 0;
+                for (size_t k = 0; k < numPaying; ++k) {
+                    n[k] = table.counts[j * numPaying + k] + shift[k];
+                    if (n[k] > 0) present |= 1ULL << k;
+                }
+                Group& g = groups[alive & present];
+                if (g.q1.empty()) {
+                    g.q1.assign(numPaying, 0.0);
+                    g.q2.assign(numPaying * numPaying, 0.0);
+                }
+                const double q = table.probs[j];
+                const uint64_t kept = alive & present & paying.keep[r];
+                g.q += q;
+                for (size_t k = 0; k < numPaying; ++k) {
+                    if (!((kept >> k) & 1ULL)) continue;
+                    g.q1[k] += q * n[k];
+                    for (size_t l = 0; l < numPaying; ++l) {
+                        if ((kept >> l) & 1ULL) g.q2[k * numPaying + l] += q * n[k] * n[l];
+                    }
+                }
+            }
+
+            for (; it != runEnd; ++it) {
+                const FoldMoments& m = it->second;
+                for (const auto& group : groups) {
+                    const Group& g = group.second;
+                    double p1, p2;
+                    FoldKey next = settle(it->first, alive & ~group.first, r, m, paying, cells, boostable, p1, p2, vpShift);
+                    next.alive &= paying.keep[r];
+                    FoldMoments& t = out[next];
+                    if (t.v1.empty()) init(t, numPaying);
+                    t.w += g.q * m.w;
+                    t.p1 += g.q * p1;
+                    t.p2 += g.q * p2;
+                    for (size_t k = 0; k < numPaying; ++k) {
+                        if (!((next.alive >> k) & 1ULL)) continue;
+                        t.v1[k] += g.q1[k] * m.v1[k];
+                        t.vp[k] += g.q1[k] * (m.vp[k] + vpShift[k]);
+                        for (size_t l = 0; l < numPaying; ++l) {
+                            if ((next.alive >> l) & 1ULL) t.vv[k * numPaying + l] += g.q2[k * numPaying + l] * m.vv[k * numPaying + l];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    static void init(FoldMoments& m, size_t numPaying) {
+        m.v1.assign(numPaying, 0.0);
+        m.vp.assign(numPaying, 0.0);
+        m.vv.assign(numPaying * numPaying, 0.0);
+    }
+
+    static void add(FoldMoments& to, const FoldMoments& from, size_t numPaying) {
+        if (to.v1.empty()) init(to, numPaying);
+        to.w += from.w;
+        to.p1 += from.p1;
+        to.p2 += from.p2;
+        for (size_t i = 0; i < from.v1.size(); ++i) to.v1[i] += from.v1[i];
+        for (size_t i = 0; i < from.vp.size(); ++i) to.vp[i] += from.vp[i];
+        for (size_t i = 0; i < from.vv.size(); ++i) to.vv[i] += from.vv[i];
+    }
+
+    // Settles every run still going after the last reel and adds the states, boosts
+    // included, to `acc` with weight `sideWeight`
+    void finish(const FoldStates& states, double sideWeight, const PayingSymbols& paying, const SideCells& cells,
+                const std::array<bool, SIDE_CELLS>& boostable, const std::array<double, SIDE_CELLS>& boostProb,
+                ExactCycleResult& acc) const {
+        std::vector<double> vpShift(paying.ids.size());
+        for (const auto& state : states) {
+            double p1, p2;
+            const FoldKey last = settle(state.first, state.first.alive, model->numReels, state.second, paying, cells,
+                                        boostable, p1, p2, vpShift);
+            // multiplier 1 + sum of m_c * B_c with B_c ~ Bernoulli(boost probability)
+            double multMean = 1.0, multVar = 0.0;
+            for (int c = 0; c < SIDE_CELLS; ++c) {
+                multMean += last.marks[c] * boostProb[c];
+                multVar += last.marks[c] * last.marks[c] * boostProb[c] * (1.0 - boostProb[c]);
+            }
+            if (last.hit) acc.hitWeight += sideWeight * state.second.w;
+            acc.payWeight += sideWeight * p1 * multMean;
+            acc.paySqWeight += sideWeight * p2 * (multVar + multMean * multMean);
+        }
+    }
+
+    // Largest pay of any screen with these side cells: depth-first over the undominated windows
+    // of each reel, cut off when even the best counts left on every reel cannot beat `best`
+    void searchMaxPay(const std::vector<ReelTable>& tables, const PayingSymbols& paying, const SideCells& cells,
+                      const std::array<bool, SIDE_CELLS>& boostable, std::atomic<double>& best) const {
+        const int numReels = model->numReels;
+        const size_t numPaying = paying.ids.size();
+        const size_t stride = static_cast<size_t>(numReels) + 1;
+
+        // reach[r][k]: most a run of k still going into reel r can add, per way so far
+        std::vector<double> reach((numReels + 1) * numPaying, 0.0);
+        for (size_t k = 0; k < numPaying; ++k) {
+            reach[numReels * numPaying + k] = paying.pay[k * stride + numReels];
+            for (int r = numReels - 1; r >= 0; --r) {
+                const int maxCount = tables[r].maxCounts[k] + cells.shift[r * numPaying + k];
+                reach[r * numPaying + k] = std::max(paying.pay[k * stride + r], maxCount * reach[(r + 1) * numPaying + k]);
+            }
+        }
+
+        std::vector<double> ways(stride * numPaying, 0.0);  // per depth
+        for (size_t k = 0; k < numPaying; ++k) ways[k] = 1.0;
+        std::array<uint8_t, SIDE_CELLS> marks{};
+
+        // windows by depth; domination holds only while longer runs never pay less
+        std::vector<const std::vector<size_t>*> order(numReels);
+        std::vector<std::vector<size_t>> all(numReels);
+        for (int r = 0; r < numReels; ++r) {
+            if (paying.nonDecreasing) order[r] = &tables[r].frontier;
+            else {
+                for (size_t j = 0; j < tables[r].probs.size(); ++j) all[r].push_back(j);
+                order[r] = &all[r];
+            }
+        }
+
+        auto raise = [&](double pay) {
+            double seen = best.load(std::memory_order_relaxed);
+            while (pay > seen && !best.compare_exchange_weak(seen, pay, std::memory_order_relaxed)) {}
+        };
+
+        auto multiplierBound = [&](uint64_t alive, const std::array<uint8_t, SIDE_CELLS>& m) {
+            double mult = 1.0;
+            for (int c = 0; c < SIDE_CELLS; ++c) {
+                if (!boostable[c]) continue;
+                uint64_t open = alive & cells.matches[c];
+                int count = 0;
+                for (; open; open &= open - 1) ++count;
+                mult += m[c] + count;
+            }
+            return mult;
+        };
+
+        // Recursion over reels; depth <= MAX_REELS
+        std::function<void(int, uint64_t, double)> visit = [&](int r, uint64_t alive, double settled) {
+            const double* v = &ways[r * numPaying];
+            if (r == numReels || alive == 0) {
+                const std::array<uint8_t, SIDE_CELLS> saved = marks;
+                double pay = settled;
+                for (size_t k = 0; k < numPaying; ++k) {
+                    if (!((alive >> k) & 1ULL)) continue;
+                    const double pk = paying.pay[k * stride + numReels];
+                    if (pk <= 0) continue;
+                    pay += pk * v[k];
+                    for (int c = 0; c < SIDE_CELLS; ++c) {
+                        if (boostable[c] && cellReel(c) < numReels && ((cells.matches[c] >> k) & 1ULL)) ++marks[c];
+                    }
+                }
+                if (pay > 0) raise(pay * multiplierBound(0, marks));
+                marks = saved;
+                return;
+            }
+
+            double reachable = settled;
+            for (size_t k = 0; k < numPaying; ++k) {
+                if ((alive >> k) & 1ULL) reachable += v[k] * reach[r * numPaying + k];
+            }
+            if (reachable * multiplierBound(alive, marks) <= best.load(std::memory_order_relaxed)) return;
+
+            const int* shift = &cells.shift[r * numPaying];
+            double* next = &ways[(r + 1) * numPaying];
+            for (size_t j : *order[r]) {
+                const int* n = &tables[r].counts[j * numPaying];
+                const std::array<uint8_t, SIDE_CELLS> saved = marks;
+                double pay = settled;
+                uint64_t kept = 0;
+                for (size_t k = 0; k < numPaying; ++k) {
+                    if (!((alive >> k) & 1ULL)) continue;
+                    const int count = n[k] + shift[k];
+                    if (count > 0) {
+                        kept |= 1ULL << k;
+                        next[k] = v[k] * count;
+                        continue;
+                    }
+                    const double pk = paying.pay[k * stride + r];
+                    if (pk <= 0) continue;
+                    pay += pk * v[k];
+                    for (int c = 0; c < SIDE_CELLS; ++c) {
+                        if (boostable[c] && cellReel(c) < r && ((cells.matches[c] >> k) & 1ULL)) ++marks[c];
+                    }
+                }
+                visit(r + 1, kept & paying.keep[r], pay);
+                marks = saved;
+            }
+        };
+        visit(0, paying.keep.empty() ? 0 : ~0ULL >> (64 - numPaying), 0.0);
+    }
+
+    ExactCycleResult evaluateReelSet(const std::string& name, int numThreads) {
+        const ReelSet& source = model->allReelSets.at(name);
+        ExactCycleResult total;
+        total.reelSetName = name;
+        if (!cycleSize(name, total.combinations)) total.combinations = 0;
+
+        const PayingSymbols paying = payingSymbols();
+        if (paying.ids.size() > 64) throw std::runtime_error("Exact evaluation supports at most 64 paying symbols");
+        const size_t numPaying = paying.ids.size();
+        const std::vector<ReelTable> tables = buildReelTables(source, paying);
+        for (const auto& table : tables) {
+            if (table.probs.empty()) return total;
+        }
+        total.totalWeight = 1.0;
+        if (numPaying == 0) return total;
+
+        std::array<bool, SIDE_CELLS> boostable{};
+        std::array<double, SIDE_CELLS> boostProb{};
+        for (int c = 0; c < SIDE_CELLS; ++c) {
+            boostProb[c] = cellReel(c) < model->numReels ? cellBoostProbability(c) : 0.0;
+            boostable[c] = boostProb[c] > 0;
+        }
+
+        // Reel 0 has no side cells, so its fold is shared by every pair of side stops
+        FoldStates first;
+        {
+            FoldKey start{ ~0ULL >> (64 - numPaying), {}, false };
+            FoldMoments& m = first[start];
+            init(m, numPaying);
+            m.w = 1.0;
+            std::fill(m.v1.begin(), m.v1.end(), 1.0);
+            std::fill(m.vv.begin(), m.vv.end(), 1.0);
+        }
+        SideCells noSide;
+        noSide.shift.assign(model->numReels * numPaying, 0);
+        FoldStates afterFirst;
+        foldReel(first, afterFirst, tables[0], &noSide.shift[0], 0, paying, noSide, boostable);
+
+        auto normalized = [](std::vector<double> w) {
+            if (w.empty()) return std::vector<double>{ 1.0 };
+            double sum = 0.0;
+            for (double x : w) sum += x;
+            for (double& x : w) x /= sum;
+            return w;
+        };
+        const std::vector<double> overProbs = normalized(stripWeights(source.getOverReel()));
+        const std::vector<double> underProbs = normalized(stripWeights(source.getUnderReel()));
+        const size_t numPairs = overProbs.size() * underProbs.size();
+
+        // Side-stop pairs are shared across workers
+        std::atomic<size_t> nextPair(0);
+        std::atomic<double> maxPay(0.0);
+        std::vector<ExactCycleResult> partials(std::max(1, numThreads));
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < partials.size(); ++t) {
+            workers.emplace_back([&, t]() {
+                FoldStates a, b;
+                size_t pair;
+                while ((pair = nextPair.fetch_add(1)) < numPairs) {
+                    const size_t over = pair / underProbs.size(), under = pair % underProbs.size();
+                    const double q = overProbs[over] * underProbs[under];
+                    if (q <= 0) continue;
+                    const SideCells cells = sideCells(source, paying, over, under);
+                    a = afterFirst;
+                    for (int r = 1; r < model->numReels; ++r) {
+                        b.clear();
+                        foldReel(a, b, tables[r], &cells.shift[r * numPaying], r, paying, cells, boostable);
+                        std::swap(a, b);
+                    }
+                    finish(a, q, paying, cells, boostable, boostProb, partials[t]);
+                    searchMaxPay(tables, paying, cells, boostable, maxPay);
+                }
+                });
+        }
+        for (auto& th : workers) th.join();
+        for (const auto& p : partials) {
+            total.hitWeight += p.hitWeight;
+            total.payWeight += p.payWeight;
+            total.paySqWeight += p.paySqWeight;
+        }
+        total.maxPay = maxPay.load();
+        return total;
+    }
+
+    // --- Screen-by-screen reference ---
+
+    // Initial-screen pay before boosts, marking the winning positions on the screen
+    double evaluate(Screen& s) const {
+        const auto& symbols = model->symbolStructure.getSymbols();
+        double pay = 0.0;
+        s.clearMarkedPositions();
+        WaysTable allWays;
+        s.getWaysForAllSymbols(static_cast<int>(symbols.size()), allWays);
+        for (SymbolId i = 0; i < symbols.size(); ++i) {
+            const auto& waysInfo = allWays[i];
+            if (waysInfo.first > 0) {
+                const double p = static_cast<double>(waysInfo.second) * model->symbolStructure.getPay(i, waysInfo.first);
+                if (p > 0) {
+                    pay += p;
+                    s.markSymbol(i, waysInfo.first);
+                }
+            }
+        }
+        return pay;
+    }
+
+    ExactCycleResult enumerateReelSet(const std::string& name, int numThreads) {
+        const ReelSet& source = model->allReelSets.at(name);
+        const std::vector<std::vector<Column>> columns = buildColumns(source);
+        const std::vector<double> overWeights = stripWeights(source.getOverReel());
+        const std::vector<double> underWeights = stripWeights(source.getUnderReel());
+
+        ExactCycleResult total;
+        total.reelSetName = name;
+        for (const auto& reelColumns : columns) if (reelColumns.empty()) return total;
+
+        // Partition the outer reel's windows across workers
+        std::atomic<size_t> nextOuter(0);
+        std::vector<ExactCycleResult> partials(std::max(1, numThreads));
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < partials.size(); ++t) {
+            workers.emplace_back([&, t]() {
+                ReelCursor rs(source);
+                Screen screen(model->numReels, 0);
+                screen.setSymbolStructure(&model->symbolStructure);
+                std::vector<int> heights(model->numReels);
+                std::vector<size_t> idx(model->numReels, 0);
+                const std::vector<bool> noBoosts(std::max({ static_cast<size_t>(Screen::SIDE_LEN),
+                    boostProbOver.size(), boostProbUnder.size() }), false);
+                const size_t overCount = std::max<size_t>(1, overWeights.size());
+                const size_t underCount = std::max<size_t>(1, underWeights.size());
+                ExactCycleResult& acc = partials[t];
+
+                size_t outer;
+                while ((outer = nextOuter.fetch_add(1)) < columns[0].size()) {
+                    std::fill(idx.begin(), idx.end(), 0);
+                    idx[0] = outer;
+                    bool done = false;
+                    while (!done) {
+                        double weight = 1.0;
+                        for (int r = 0; r < model->numReels; ++r) {
+                            const Column& c = columns[r][idx[r]];
+                            heights[r] = c.height;
+                            rs.currentIndices[r] = c.stop;
+                            weight *= c.weight;
+                        }
+                        screen.resize(heights);
+                        screen.generateScreen(rs);
+
+                        for (size_t o = 0; o < overCount; ++o) {
+                            for (size_t u = 0; u < underCount; ++u) {
+                                double w = weight;
+                                if (!overWeights.empty()) {
+                                    rs.currentOverIndex = static_cast<int>(o);
+                                    screen.addSideSymbols(true, rs, noBoosts);
+                                    w *= overWeights[o];
+                                }
+                                if (!underWeights.empty()) {
+                                    rs.currentUnderIndex = static_cast<int>(u);
+                                    screen.addSideSymbols(false, rs, noBoosts);
+                                    w *= underWeights[u];
+                                }
+                                accumulate(acc, screen, w);
+                            }
+                        }
+
+                        // advance the inner reels like an odometer (reel 0 stays fixed)
+                        int r = model->numReels - 1;
+                        for (; r >= 1; --r) {
+                            if (++idx[r] < columns[r].size()) break;
+                            idx[r] = 0;
+                        }
+                        done = (r < 1);
+                    }
+                }
+                });
+        }
+        for (auto& th : workers) th.join();
+        for (const auto& p : partials) total.merge(p);
+        return total;
+    }
+
+    // Add one combination: the multiplier is 1 + sum of m_c * B_c over winning side cells c,
+    // where m_c is how many wins marked the cell and B_c ~ Bernoulli(boost probability).
+    void accumulate(ExactCycleResult& acc, Screen& screen, double weight) const {
+        ++acc.combinations;
+        acc.totalWeight += weight;
+        const double pay = evaluate(screen);
+        if (pay <= 0) return;
+
+        double multMean = 1.0, multVar = 0.0;
+        int overMarks[8] = { 0 }, underMarks[8] = { 0 };
+        for (const auto& pos : screen.getMarkedPositions()) {
+            if (pos.second == -1) ++overMarks[pos.first - 1];
+            else if (pos.second == -2) ++underMarks[pos.first - 1];
+        }
+        for (size_t b = 0; b < boostProbOver.size() && b < 8; ++b) {
+            const double p = boostProbOver[b];
+            multMean += overMarks[b] * p;
+            multVar += overMarks[b] * overMarks[b] * p * (1.0 - p);
+        }
+        for (size_t b = 0; b < boostProbUnder.size() && b < 8; ++b) {
+            const double p = boostProbUnder[b];
+            multMean += underMarks[b] * p;
+            multVar += underMarks[b] * underMarks[b] * p * (1.0 - p);
+        }
+
+        acc.hitWeight += weight;
+        acc.payWeight += weight * pay * multMean;
+        acc.paySqWeight += weight * pay * pay * (multVar + multMean * multMean);
+        double maxMult = 1.0;
+        for (size_t b = 0; b < boostProbOver.size() && b < 8; ++b)
+            if (boostProbOver[b] > 0) maxMult += overMarks[b];
+        for (size_t b = 0; b < boostProbUnder.size() && b < 8; ++b)
+            if (boostProbUnder[b] > 0) maxMult += underMarks[b];
+        if (pay * maxMult > acc.maxPay) acc.maxPay = pay * maxMult;
+    }
+};
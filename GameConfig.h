@@ -4,6 +4,7 @@
 #include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -129,48 +130,49 @@ public:
     }
 
     ReelSet parseReelSet(const std::string& reelSetName, std::string maskName = "") {
-        auto& reelSetConfig = config_json["reel_sets"];
-        for (auto& item : reelSetConfig) {
+        return parseReelSet(reelSetName, parseSymbolStructure(), maskName);
+    }
+
+    ReelSet parseReelSet(const std::string& reelSetName, const SymbolStructure& symbolStructure, std::string maskName = "") {
+        for (auto& item : config_json["reel_sets"]) {
             if (item["name"] == reelSetName) {
-                std::vector<Reel> reels;
-                auto& reelsConfig = item["reels"];
-                for (auto& reelConfig : reelsConfig) {
-                    std::vector<std::string> symbols = reelConfig["symbols"].get<std::vector<std::string>>();
-                    std::vector<int> weights;
-                    if (reelConfig.contains("weights")) weights = reelConfig["weights"].get<std::vector<int>>();
-                    reels.push_back(Reel(symbols, weights));
-                }
-                std::string mask = maskName.empty() ? static_cast<std::string>(item["mask"]) : maskName;
-
-                Reel* overReel = nullptr;
-                Reel* underReel = nullptr;
-                std::string overMask = "", underMask = "";
-                if (item.contains("overReel")) {
-                    auto& o = item["overReel"];
-                    std::vector<int> w; if (o.contains("weights")) w = o["weights"].get<std::vector<int>>();
-                    overReel = new Reel(o["symbols"].get<std::vector<std::string>>(), w);
-                    overMask = o.contains("mask") ? static_cast<std::string>(o["mask"]) : mask + "_OVER";
-                }
-                if (item.contains("underReel")) {
-                    auto& u = item["underReel"];
-                    std::vector<int> w; if (u.contains("weights")) w = u["weights"].get<std::vector<int>>();
-                    underReel = new Reel(u["symbols"].get<std::vector<std::string>>(), w);
-                    underMask = u.contains("mask") ? static_cast<std::string>(u["mask"]) : mask + "_UNDER";
-                }
-
-                ReelSet result(reels, mask, overReel, overMask, underReel, underMask);
-                delete overReel; delete underReel;
+                ReelSet result = buildReelSet(item, maskName);
+                result.bindSymbols(symbolStructure);
                 return result;
             }
         }
         throw std::invalid_argument("ReelSet not found: " + reelSetName);
     }
 
+    // Reel-set names in outcome order of a reel-weight table: "baseReelSets" follows
+    // reelWeights and "freeReelSets" follows reelWeightsFree. Configs without the key get
+    // the original MegaWays order.
+    std::vector<std::string> parseReelSetOrder(const std::string& key) {
+        if (config_json.contains(key)) return parseVec<std::string>(key);
+        if (key == "baseReelSets") return { "baseLow", "baseHigh", "baseTumble", "noWin1" };
+        if (key == "freeReelSets") return { "freeLow", "freeHigh" };
+        throw std::invalid_argument("Key not found: " + key);
+    }
+
+    // Weight-profile keys found in both reelWeights and reelWeightsFree (the RTP variants)
+    std::vector<std::string> parseRtpKeys() {
+        if (!config_json.contains("reelWeights")) throw std::invalid_argument("Key not found: reelWeights");
+        if (!config_json.contains("reelWeightsFree")) throw std::invalid_argument("Key not found: reelWeightsFree");
+        std::vector<std::string> keys;
+        for (auto& item : config_json["reelWeights"].items()) {
+            if (config_json["reelWeightsFree"].contains(item.key())) keys.push_back(item.key());
+        }
+        return keys;
+    }
+
+    // Every reel set by name, strips as written; GameModel checks their symbols and binds them
     std::unordered_map<std::string, ReelSet> parseAllReelSets() {
         std::unordered_map<std::string, ReelSet> reelSetsMap;
         for (auto& item : config_json["reel_sets"]) {
             std::string name = item["name"];
-            reelSetsMap[name] = parseReelSet(name);
+            if (!reelSetsMap.emplace(name, buildReelSet(item)).second) {
+                throw std::invalid_argument("Duplicate reel set name: " + name);
+            }
         }
         return reelSetsMap;
     }
@@ -178,19 +180,24 @@ public:
     // Prize distributions by name or vector
     template <typename PrizeType>
     PrizeDistribution<PrizeType> parsePrizeDistribution(const std::string& prizeDistName, std::string subLevel = "") {
-        json prizeDistConfig = config_json;
+        // Walk to the node by pointer, so no distribution copies the whole document
+        const json* node = &config_json;
         if (!subLevel.empty()) {
             std::istringstream subLevelStream(subLevel);
             std::string level;
-            while (getline(subLevelStream, level, '/')) prizeDistConfig = prizeDistConfig[level];
+            while (getline(subLevelStream, level, '/')) node = &node->at(level);
         }
-        prizeDistConfig = prizeDistConfig[prizeDistName];
+        const json& prizeDistConfig = node->at(prizeDistName);
 
-        std::string mask = prizeDistConfig["mask"];
-        std::vector<PrizeType> prizes = prizeDistConfig["prizes"].get<std::vector<PrizeType>>();
+        std::string mask = prizeDistConfig.at("mask");
+        std::vector<PrizeType> prizes = prizeDistConfig.at("prizes").get<std::vector<PrizeType>>();
         std::vector<int> weights = prizeDistConfig.contains("weights")
-            ? prizeDistConfig["weights"].get<std::vector<int>>()
+            ? prizeDistConfig.at("weights").get<std::vector<int>>()
             : std::vector<int>(prizes.size(), 1);
+        if (weights.size() != prizes.size()) {
+            throw std::invalid_argument((subLevel.empty() ? "" : subLevel + "/") + prizeDistName + " has " +
+                std::to_string(prizes.size()) + " prizes but " + std::to_string(weights.size()) + " weights");
+        }
         return PrizeDistribution<PrizeType>(mask, prizes, weights);
     }
 
@@ -204,4 +211,49 @@ public:
         }
         return v;
     }
+
+    // Side-row boost distributions (prize 1 = boosted), one per side cell, from
+    // "boostWeightsOver"/"boostWeightsUnder". Configs with only the older "boostWeights"
+    // arrays use them for both rows; configs with neither have no boosts.
+    std::vector<PrizeDistribution<int>> parseBoostPDs(bool over) {
+        const std::string key = over ? "boostWeightsOver" : "boostWeightsUnder";
+        if (config_json.contains(key)) return parsePDVec<int>(key);
+
+        std::vector<PrizeDistribution<int>> v;
+        if (!config_json.contains("boostWeights")) return v;
+        const auto weights = parseArray<int>("boostWeights");
+        for (size_t i = 0; i < weights.size(); ++i) {
+            v.emplace_back("BS_" + std::to_string(i + 1), std::vector<int>{ 0, 1 }, weights[i]);
+        }
+        return v;
+    }
+
+private:
+    // One "reel_sets" entry with its optional over/under reels, symbols not yet bound
+    static ReelSet buildReelSet(const json& item, const std::string& maskName = "") {
+        std::vector<Reel> reels;
+        for (auto& reelConfig : item.at("reels")) {
+            std::vector<std::string> symbols = reelConfig.at("symbols").get<std::vector<std::string>>();
+            std::vector<int> weights;
+            if (reelConfig.contains("weights")) weights = reelConfig.at("weights").get<std::vector<int>>();
+            reels.push_back(Reel(symbols, weights));
+        }
+        std::string mask = maskName.empty() ? item.at("mask").get<std::string>() : maskName;
+
+        std::unique_ptr<Reel> overReel, underReel;
+        std::string overMask = "", underMask = "";
+        if (item.contains("overReel")) {
+            auto& o = item.at("overReel");
+            std::vector<int> w; if (o.contains("weights")) w = o.at("weights").get<std::vector<int>>();
+            overReel.reset(new Reel(o.at("symbols").get<std::vector<std::string>>(), w));
+            overMask = o.contains("mask") ? o.at("mask").get<std::string>() : mask + "_OVER";
+        }
+        if (item.contains("underReel")) {
+            auto& u = item.at("underReel");
+            std::vector<int> w; if (u.contains("weights")) w = u.at("weights").get<std::vector<int>>();
+            underReel.reset(new Reel(u.at("symbols").get<std::vector<std::string>>(), w));
+            underMask = u.contains("mask") ? u.at("mask").get<std::string>() : mask + "_UNDER";
+        }
+        return ReelSet(reels, mask, overReel.get(), overMask, underReel.get(), underMask);
+    }
 };
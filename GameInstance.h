@@ -1,68 +1,32 @@
 #pragma once
-#include "GameConfig.h"
+#include "GameModel.h"
 #include "Stats.h"
 #include "Screen.h"
 
 class GameInstance {
 private:
-    std::shared_ptr<GameConfig> config;
+    std::shared_ptr<const GameModel> model;
+    const RtpVariant* variant; // reel-set weights this instance plays
     Stats& stats;
-    SymbolStructure symbolStructure;
-    std::string rtpKey;
-
-    // Flags / core params
-    GameFlags flags;
-    int numReels = 0;
-    int fixedRows = 3; // used when megaways=false
-    std::vector<PrizeDistribution<int>> reelHeightPD, reelHeightFreePD;
-
-    int cost = 0;
-    std::vector<std::string> symbols;
-    std::map<std::string, std::vector<int>> paytable;
-    std::vector<std::string> payHeaders;
-
-    std::vector<std::vector<int>> boostWeights;
-    std::vector<PrizeDistribution<int>> boostPDVec;
-    std::vector<bool> boostVecOver, boostVecUnder;
-
-    // ReelSets
-    std::unordered_map<std::string, ReelSet> allReelSets;
-    std::vector<int> reelWeights, reelWeightsFree;
-    PrizeDistribution<int> ReelsPD;
-
-    // Game state
+
+    std::vector<bool> boostVecOver, boostVecUnder;  // sized once; at least one flag per side cell
+
+    // Game state; buffers are sized once so a round in steady state does not allocate
     Screen screen;
+    Screen fsScreen;
+    std::vector<double> roundPays;          // per pay header, reused every round
+    std::array<int, MAX_REELS> reelHeights{};
+
+    // Feature counters, registered with stats up front
+    FeatureId baseWinFeature, baseFeature, freeSpinsFeature, fsTeaseFeature;
+    std::vector<FeatureId> fsTriggerFeatures;   // by scatter count, from 3 to maxScatterCount()
     int lastReelSetID = -1;
+    long long nextSpinIndex = 0; // global index of the next round; selects its RNG stream
 
     enum PayIdx { INITIAL = 0, TUMBLE, BASE, FREE_TOTAL, TOTAL };
 
-    void initializeGame() {
-        rtpKey = config->getRTPKey();
-        flags = config->getGameFlags();
-        numReels = config->getReels();
-        payHeaders = config->getRTPHeaders();
-        symbolStructure = config->parseSymbolStructure();
-        allReelSets = config->parseAllReelSets();
-        reelWeights = config->parseVec<int32_t>("reelWeights", rtpKey);
-        reelWeightsFree = config->parseVec<int32_t>("reelWeightsFree", rtpKey);
-        ReelsPD = PrizeDistribution<int>("R-WTS", std::vector<int>{0, 1, 2, 3}, reelWeights);
-        cost = config->getCost();
-        symbols = symbolStructure.getSymbols();
-        paytable = symbolStructure.getPaytable();
-
-        // Heights PDs only if megaways = true
-        if (flags.megaways) {
-            reelHeightPD = config->parsePDVec<int>("reelHeights");
-            reelHeightFreePD = config->parsePDVec<int>("reelHeightsFree");
-        }
-        else {
-            reelHeightPD.clear();
-            reelHeightFreePD.clear();
-        }
-
-        // Optional boosts
-        boostWeights = config->parseArray<int>("boostWeights");
-    }
+    // Every cell marked once; a cell shared by several wins can still grow the vector during warm-up
+    static constexpr size_t MAX_MARKED = MAX_REELS * MAX_ROWS + 2 * Screen::SIDE_LEN;
 
     // --- evaluation helpers ---
     double calculateWaysWins(Screen& s, bool baseGame, int currentMult = 1) {
@@ -70,13 +34,16 @@ private:
         if (logMode != NO_LOGGING) RandomLogGenerator::addScreen(s.toJson(true, true));
         s.clearMarkedPositions();
 
-        for (const auto& sym : symbols) {
-            auto waysInfo = s.getWaysForSymbol(sym);
+        const SymbolStructure& symbolStructure = model->symbolStructure;
+        WaysTable allWays;
+        s.getWaysForAllSymbols(static_cast<int>(model->symbols.size()), allWays);
+        for (SymbolId sym = 0; sym < model->symbols.size(); ++sym) {
+            const auto& waysInfo = allWays[sym];
             int length = waysInfo.first;
             int ways = waysInfo.second;
             int payout = 0;
             if (length > 0) {
-                payout = currentMult * ways * paytable[sym][length - 1];
+                payout = currentMult * ways * symbolStructure.getPay(sym, length);
                 if (payout > 0) {
                     stats.trackResult(sym, length, ways, payout, baseGame);
                     s.markSymbol(sym, length);
@@ -120,10 +87,57 @@ private:
         return boostCount;
     }
 
-    std::pair<double, double> doOneEvaluation(Screen& s, ReelSet& rs, bool baseGame, int& globalMult) {
+    void registerFeatures() {
+        baseWinFeature = stats.registerFeature("Base Win");
+        baseFeature = stats.registerFeature("Base");
+        freeSpinsFeature = stats.registerFeature("Free Spins");
+        fsTeaseFeature = stats.registerFeature("FS Tease");
+        const int maxCount = maxScatterCount();
+        fsTriggerFeatures.assign(maxCount + 1, -1);
+        for (int count = 3; count <= maxCount; ++count) {
+            fsTriggerFeatures[count] = stats.registerFeature("FS Trigger " + std::to_string(count));
+        }
+    }
+
+    // Most scatters a base-game screen can show: the tallest column of every reel whose strip
+    // carries the scatter, plus the side cells (middle reels only) of a side strip that does
+    int maxScatterCount() const {
+        if (model->scatterId == EMPTY_SYMBOL) return 0;
+        auto carries = [&](const Reel* reel) {
+            return reel && std::find(reel->ids.begin(), reel->ids.end(), model->scatterId) != reel->ids.end();
+        };
+        const int sideCells = std::max(0, std::min(static_cast<int>(Screen::SIDE_LEN), model->numReels - 1));
+        int maxCount = 0;
+        for (const ReelSet* reelSet : model->baseReelSets) {
+            int count = 0;
+            for (int r = 0; r < model->numReels; ++r) {
+                if (!carries(&reelSet->reels[r])) continue;
+                if (!model->flags.megaways) count += model->symbolStructure.getWinLength();
+                else {
+                    const auto& heights = model->reelHeightPD[r].getPrizes();
+                    count += *std::max_element(heights.begin(), heights.end());
+                }
+            }
+            if (carries(reelSet->getOverReel())) count += sideCells;
+            if (carries(reelSet->getUnderReel())) count += sideCells;
+            maxCount = std::max(maxCount, count);
+        }
+        return maxCount;
+    }
+
+    // Side cells boosted this round; over and under draws alternate per cell
+    void rollBoosts() {
+        const size_t nOver = model->boostOverPD.size(), nUnder = model->boostUnderPD.size();
+        for (size_t b = 0; b < std::max(nOver, nUnder); ++b) {
+            if (b < nOver) boostVecOver[b] = model->boostOverPD[b].getRandomPrize() != 0;
+            if (b < nUnder) boostVecUnder[b] = model->boostUnderPD[b].getRandomPrize() != 0;
+        }
+    }
+
+    std::pair<double, double> doOneEvaluation(Screen& s, ReelCursor& rs, bool baseGame, int& globalMult) {
         // returns {initialWin, tumbleWinAdded}
         double init = 0, tumble = 0;
-        if (flags.mode == GameMode::WAYS) {
+        if (model->flags.mode == GameMode::WAYS) {
             init = calculateWaysWins(s, baseGame);
         }
         else {
@@ -136,60 +150,81 @@ private:
     }
 
 public:
-    explicit GameInstance(std::shared_ptr<GameConfig> cfg, SymbolStructure& ss, Stats& st)
-        : config(cfg), stats(st), symbolStructure(ss) {
-        initializeGame();
+    // Shares an already compiled model; cheap enough to create one instance per worker or player.
+    // Plays the RTP variant model->rtpVariants[variantIndex].
+    GameInstance(std::shared_ptr<const GameModel> gameModel, Stats& st, size_t variantIndex)
+        : model(std::move(gameModel)), variant(&model->rtpVariants.at(variantIndex)), stats(st),
+          boostVecOver(std::max(static_cast<size_t>(Screen::SIDE_LEN), model->boostOverPD.size()), false),
+          boostVecUnder(std::max(static_cast<size_t>(Screen::SIDE_LEN), model->boostUnderPD.size()), false),
+          roundPays(model->payHeaders.size(), 0.0) {
+        screen.setSymbolStructure(&model->symbolStructure);
+        fsScreen.setSymbolStructure(&model->symbolStructure);
+        screen.markedPositions.reserve(MAX_MARKED);
+        fsScreen.markedPositions.reserve(MAX_MARKED);
+        registerFeatures();
+    }
+
+    // Plays the model's default variant (game.RTP)
+    GameInstance(std::shared_ptr<const GameModel> gameModel, Stats& st)
+        : GameInstance(gameModel, st, gameModel->defaultVariant) {
+    }
+
+    // Heap instances keep the 64-byte alignment of their screens, which a plain new only
+    // guarantees from C++17 on: over-allocate, align, and keep the raw pointer just below
+    static void* operator new(size_t size) {
+        constexpr size_t align = alignof(GameInstance);
+        void* raw = ::operator new(size + align);
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + align) & ~static_cast<uintptr_t>(align - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<void*>(aligned);
+    }
+    static void operator delete(void* p) {
+        if (p) ::operator delete(static_cast<void**>(p)[-1]);
+    }
+
+    // Back to the state of a freshly created instance, ready for the next session
+    void reset() {
+        std::fill(boostVecOver.begin(), boostVecOver.end(), false);
+        std::fill(boostVecUnder.begin(), boostVecUnder.end(), false);
+        lastReelSetID = -1;
+        nextSpinIndex = 0;
     }
 
     double simulateSingleSpin() {
         playBaseGame(1);
         double lastSpinPayout = stats.getLastSpinPayout();
-        return lastSpinPayout - cost;
+        return lastSpinPayout - model->cost;
     }
 
     void playBaseGame(long long numSpins) {
-        std::vector<PrizeDistribution<int>> localBoostPD(boostWeights.size());
-        for (size_t i = 0; i < boostWeights.size(); ++i) {
-            localBoostPD[i] = PrizeDistribution<int>("BS_" + std::to_string(i + 1), std::vector<int>{0, 1}, boostWeights[i]);
-        }
-
         for (long long i = 0; i < numSpins; ++i) {
             double basePay = 0.0;
             int globalMult = 1;
+            if (logMode != REPLAY) beginRandomStream(static_cast<uint64_t>(nextSpinIndex));
+            ++nextSpinIndex;
             RandomLogGenerator::startRound();
 
-            std::vector<double> pays(payHeaders.size(), 0.0);
+            std::vector<double>& pays = roundPays;
+            std::fill(pays.begin(), pays.end(), 0.0);
 
             // Resize screen
-            if (flags.megaways) {
-                std::vector<int> heights(numReels);
-                for (int r = 0; r < numReels; ++r) heights[r] = reelHeightPD[r].getRandomPrize();
-                screen.resize(heights);
+            if (model->flags.megaways) {
+                for (int r = 0; r < model->numReels; ++r) reelHeights[r] = model->reelHeightPD[r].getRandomPrize();
+                screen.resize(reelHeights.data(), model->numReels);
             }
             else {
                 // fixed height: use paytable length or a fixed constant
-                int rows = symbolStructure.getWinLength(); // reasonable default
-                screen.resize(std::vector<int>(numReels, rows));
+                int rows = model->symbolStructure.getWinLength(); // reasonable default
+                screen.resize(model->numReels, rows);
             }
 
-            int reelID = ReelsPD.getRandomPrize();
+            int reelID = variant->ReelsPD.getRandomPrize();
             lastReelSetID = reelID;
-            ReelSet activeReels;
-            switch (reelID) {
-            case 0: activeReels = allReelSets["baseLow"];    break;
-            case 1: activeReels = allReelSets["baseHigh"];   break;
-            case 2: activeReels = allReelSets["baseTumble"]; break;
-            case 3: activeReels = allReelSets["noWin1"];     break;
-            }
+            ReelCursor activeReels(*model->baseReelSets[reelID]);
 
             activeReels.spinReels();
 
-            // boosts roll
-            boostVecOver.clear(); boostVecUnder.clear();
-            for (size_t b = 0; b < boostWeights.size(); ++b) {
-                boostVecOver.push_back(localBoostPD[b].getRandomPrize());
-                boostVecUnder.push_back(localBoostPD[b].getRandomPrize());
-            }
+            rollBoosts();
 
             // Draw main + side
             screen.generateScreen(activeReels);
@@ -197,7 +232,7 @@ public:
             if (activeReels.hasUnderReel()) screen.addSideSymbols(false, activeReels, boostVecUnder);
 
             // cascades?
-            if (flags.cascades) {
+            if (model->flags.cascades) {
                 // Tumble loop (your original cascade logic preserved) :contentReference[oaicite:5]{index=5}
                 bool hasNewWins;
                 double initialWin = 0, tumbleWin = 0;
@@ -207,14 +242,14 @@ public:
                     hasNewWins = false;
                     screen.clearMarkedPositions();
                     if (tumbleCount == 0) {
-                        double w = (flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
+                        double w = (model->flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
                         globalMult += boostsInWin(screen);
                         w *= globalMult;
                         initialWin += w;
                         RandomLogGenerator::addWinAmount(w);
                     }
                     else {
-                        double w = (flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
+                        double w = (model->flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
                         globalMult += boostsInWin(screen);
                         w *= globalMult;
                         tumbleWin += w;
@@ -236,74 +271,67 @@ public:
                 stats.recordFinalMult(globalMult);
 
                 basePay = initialWin + tumbleWin;
-                if (basePay) stats.trackFeatureActivation("Base Win");
+                if (basePay) stats.trackFeatureActivation(baseWinFeature);
                 pays[INITIAL] += initialWin;
                 pays[TUMBLE] += (basePay - initialWin);
                 pays[BASE] += basePay;
             }
             else {
                 // Single pass (no cascades)
-                double initialWin = (flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
+                double initialWin = (model->flags.mode == GameMode::WAYS) ? calculateWaysWins(screen, true) : calculateLineWins(screen, true);
                 globalMult += boostsInWin(screen);
                 initialWin *= globalMult;
                 RandomLogGenerator::addWinAmount(initialWin);
                 stats.recordFinalMult(globalMult);
 
                 basePay = initialWin;
-                if (basePay) stats.trackFeatureActivation("Base Win");
+                if (basePay) stats.trackFeatureActivation(baseWinFeature);
                 pays[INITIAL] += initialWin;
                 pays[BASE] += basePay;
             }
 
             // Simple FS trigger demo (as in your code) using F1 count
-            int fgCount = screen.countSymbolOnScreen("F1", false);
+            int fgCount = screen.countSymbolOnScreen(model->scatterId, false);
             if (fgCount >= 3) {
-                std::vector<double> fv = playFreeGames(5 * (fgCount - 3) + 10, (fgCount - 3) + 2);
-                stats.trackFeatureActivation("FS Trigger " + std::to_string(fgCount));
-                stats.trackFeatureActivation("Free Spins");
-                pays[FREE_TOTAL] += fv[0];
+                const double freeWin = playFreeGames(5 * (fgCount - 3) + 10, (fgCount - 3) + 2);
+                stats.trackFeatureActivation(fsTriggerFeatures[fgCount]);
+                stats.trackFeatureActivation(freeSpinsFeature);
+                pays[FREE_TOTAL] += freeWin;
             }
             else if (fgCount == 2) {
-                stats.trackFeatureActivation("FS Tease");
+                stats.trackFeatureActivation(fsTeaseFeature);
             }
 
             RandomLogGenerator::endRound();
             pays[TOTAL] = pays[INITIAL] + pays[TUMBLE] + pays[FREE_TOTAL];
-            if (pays[TOTAL]) stats.trackFeatureActivation("Base");
+            if (pays[TOTAL]) stats.trackFeatureActivation(baseFeature);
             stats.completeWager(pays);
         }
     }
 
-    std::vector<double> playFreeGames(int numFreeGames, int initMult) {
-        std::vector<double> pays(2, 0.0);
+    // Plays a free-spin feature and returns its total win
+    double playFreeGames(int numFreeGames, int initMult) {
+        double totalWin = 0.0;
         int multiplier = initMult;
         int freeSpinsRemaining = numFreeGames;
 
-        boostVecOver = std::vector<bool>(boostWeights.size(), true);
-        boostVecUnder = std::vector<bool>(boostWeights.size(), true);
+        std::fill(boostVecOver.begin(), boostVecOver.begin() + model->boostOverPD.size(), true);
+        std::fill(boostVecUnder.begin(), boostVecUnder.begin() + model->boostUnderPD.size(), true);
 
-        Screen fsScreen(numReels, 0);
-        fsScreen.clearScreen();
+        fsScreen.reset(model->numReels);
 
         while (freeSpinsRemaining-- > 0) {
             RandomLogGenerator::newSpin();
-            if (flags.megaways) {
-                std::vector<int> heights(numReels);
-                for (int r = 0; r < numReels; ++r) heights[r] = reelHeightFreePD[r].getRandomPrize();
-                fsScreen.resize(heights);
+            if (model->flags.megaways) {
+                for (int r = 0; r < model->numReels; ++r) reelHeights[r] = model->reelHeightFreePD[r].getRandomPrize();
+                fsScreen.resize(reelHeights.data(), model->numReels);
             }
             else {
-                int rows = symbolStructure.getWinLength();
-                fsScreen.resize(std::vector<int>(numReels, rows));
+                int rows = model->symbolStructure.getWinLength();
+                fsScreen.resize(model->numReels, rows);
             }
 
-            ReelSet freeReelSet;
-            if (getRand("FR-WTS", reelWeightsFree[0] + reelWeightsFree[1]) < reelWeightsFree[0]) {
-                freeReelSet = allReelSets["freeLow"];
-            }
-            else {
-                freeReelSet = allReelSets["freeHigh"];
-            }
+            ReelCursor freeReelSet(*model->freeReelSets[variant->FreeReelsPD.getRandomPrize()]);
             freeReelSet.spinReels();
 
             fsScreen.generateScreen(freeReelSet);
@@ -318,7 +346,7 @@ public:
             do {
                 hasNewWins = false;
                 fsScreen.clearMarkedPositions();
-                double w = (flags.mode == GameMode::WAYS) ? calculateWaysWins(fsScreen, false) : calculateLineWins(fsScreen, false);
+                double w = (model->flags.mode == GameMode::WAYS) ? calculateWaysWins(fsScreen, false) : calculateLineWins(fsScreen, false);
                 multiplier += boostsInWin(fsScreen);
                 w *= multiplier;
                 if (tumbleCount == 0) init += w; else tumble += w;
@@ -334,14 +362,18 @@ public:
                 }
             } while (hasNewWins);
 
-            pays[0] += init + tumble;
+            totalWin += init + tumble;
         }
 
         stats.recordFreeSpins(numFreeGames);
         stats.recordFinalMultFree(multiplier);
         stats.recordFinalMultFreeByInit(initMult, multiplier);
-        return pays;
+        return totalWin;
     }
 
     int getLastReelSetID() const { return lastReelSetID; }
+
+    // Position the next round at a global spin index (each round owns RNG stream = its index)
+    void setSpinIndex(long long index) { nextSpinIndex = index; }
+    long long getSpinIndex() const { return nextSpinIndex; }
 };
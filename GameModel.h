@@ -0,0 +1,314 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <climits>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+
+#include "GameConfig.h"
+
+// Reel-set weights of one RTP variant. Variants share every strip and table of the model;
+// they differ only in how the base and free reel sets are drawn.
+struct RtpVariant {
+    std::string rtpKey;
+    std::vector<int> reelWeights, reelWeightsFree;
+    PrizeDistribution<int> ReelsPD;     // outcome i draws baseReelSets[i]
+    PrizeDistribution<int> FreeReelsPD; // outcome i draws freeReelSets[i]
+};
+
+// Everything a game round reads but never writes, compiled once from GameConfig: flags,
+// symbols, reel sets, height distributions, boosts, and the reel-set weights of every RTP
+// variant. It is built before any worker starts and shared read-only by every
+// GameInstance, so creating an instance does not touch the JSON tree. Reel-set tables
+// point into allReelSets, hence no copies. GameModelFile saves the source fields to a
+// binary file and loads them back.
+//
+// Both load paths end in compileTables(), which validates the whole model first: every
+// strip symbol and wild substitution must be in the paytable, every pays row must cover
+// game.reels lengths with no ragged rows, reel weights must match
+// their strips, distributions need as many weights as prizes and a positive total, and
+// the reel-set tables must name existing sets of numReels reels with one weight per set
+// in every RTP variant. All problems are reported together in one exception, before any
+// spin runs. Reel sets that no variant can draw are not errors; they are listed in
+// `warnings`.
+class GameModel {
+public:
+    explicit GameModel(GameConfig& config) {
+        const auto gameInfo = config.getGameInfo();
+        gameName = gameInfo[0];
+        modeLabel = gameInfo[2];
+        rtpKey = config.getRTPKey();
+        flags = config.getGameFlags();
+        numReels = config.getReels();
+        cost = config.getCost();
+        payHeaders = config.getRTPHeaders();
+        symbolStructure = config.parseSymbolStructure();
+
+        allReelSets = config.parseAllReelSets();
+        for (const auto& key : config.parseRtpKeys()) {
+            RtpVariant variant;
+            variant.rtpKey = key;
+            variant.reelWeights = config.parseVec<int32_t>("reelWeights", key);
+            variant.reelWeightsFree = config.parseVec<int32_t>("reelWeightsFree", key);
+            rtpVariants.push_back(std::move(variant));
+        }
+        baseReelSetNames = config.parseReelSetOrder("baseReelSets");
+        freeReelSetNames = config.parseReelSetOrder("freeReelSets");
+
+        // Heights PDs only if megaways = true
+        if (flags.megaways) {
+            reelHeightPD = config.parsePDVec<int>("reelHeights");
+            reelHeightFreePD = config.parsePDVec<int>("reelHeightsFree");
+        }
+
+        // Optional side-row boosts, compiled once; rounds only sample them
+        boostOverPD = config.parseBoostPDs(true);
+        boostUnderPD = config.parseBoostPDs(false);
+
+        compileTables();
+    }
+
+    // Reel-set tables hold pointers into allReelSets
+    GameModel(const GameModel&) = delete;
+    GameModel& operator=(const GameModel&) = delete;
+
+    // [gameName, RTP, modeLabel], as GameConfig::getGameInfo
+    std::vector<std::string> getGameInfo() const { return { gameName, rtpKey, modeLabel }; }
+
+    std::string gameName, modeLabel;
+    std::string rtpKey;
+    GameFlags flags;
+    int numReels = 0;
+    int cost = 0;
+    std::vector<std::string> payHeaders;
+
+    SymbolStructure symbolStructure;
+    std::vector<std::string> symbols;
+    SymbolId scatterId = EMPTY_SYMBOL;
+
+    std::unordered_map<std::string, ReelSet> allReelSets;
+    std::vector<std::string> baseReelSetNames, freeReelSetNames;
+    std::vector<const ReelSet*> baseReelSets, freeReelSets; // indexed by ReelsPD / FreeReelsPD outcome
+
+    // Every key present in both reelWeights and reelWeightsFree; rtpKey (game.RTP) is the default
+    std::vector<RtpVariant> rtpVariants;
+    size_t defaultVariant = 0;
+
+    const RtpVariant& getDefaultVariant() const { return rtpVariants[defaultVariant]; }
+
+    // Index into rtpVariants, or -1
+    int findVariant(const std::string& key) const {
+        for (size_t v = 0; v < rtpVariants.size(); ++v) {
+            if (rtpVariants[v].rtpKey == key) return static_cast<int>(v);
+        }
+        return -1;
+    }
+
+    std::vector<PrizeDistribution<int>> reelHeightPD, reelHeightFreePD;
+
+    std::vector<PrizeDistribution<int>> boostOverPD, boostUnderPD;  // one per side cell, prize 1 = boosted
+
+    std::vector<std::string> warnings; // non-fatal findings of the load-time validation
+
+private:
+    friend class GameModelFile;
+    GameModel() = default;
+
+    // Tables derived from the source fields above
+    void compileTables() {
+        validate();
+        for (auto& item : allReelSets) item.second.bindSymbols(symbolStructure);
+
+        symbols = symbolStructure.getSymbols();
+        int f1 = symbolStructure.findSymbolIndex("F1");
+        scatterId = f1 < 0 ? EMPTY_SYMBOL : static_cast<SymbolId>(f1);
+
+        baseReelSets = resolveReelSets(baseReelSetNames);
+        freeReelSets = resolveReelSets(freeReelSetNames);
+        for (auto& variant : rtpVariants) {
+            variant.ReelsPD = PrizeDistribution<int>("R-WTS", outcomeIndices(variant.reelWeights.size()), variant.reelWeights);
+            variant.FreeReelsPD = PrizeDistribution<int>("FR-WTS", outcomeIndices(variant.reelWeightsFree.size()), variant.reelWeightsFree);
+        }
+        defaultVariant = static_cast<size_t>(findVariant(rtpKey));
+    }
+
+    // Dense reel-set table: entry i is the set drawn on outcome i (names checked by validate())
+    std::vector<const ReelSet*> resolveReelSets(const std::vector<std::string>& names) const {
+        std::vector<const ReelSet*> sets;
+        for (const auto& name : names) sets.push_back(&allReelSets.at(name));
+        return sets;
+    }
+
+    // Checks the source fields before anything is derived from them; throws with every error found
+    void validate() {
+        std::vector<std::string> errors;
+        warnings.clear();
+
+        if (numReels < 1 || numReels > MAX_REELS) {
+            errors.push_back("game.reels is " + std::to_string(numReels) + ", must be 1.." + std::to_string(MAX_REELS));
+        }
+        if (cost <= 0) errors.push_back("game.cost must be positive");
+        if (!flags.megaways && symbolStructure.getWinLength() > MAX_ROWS) {
+            errors.push_back("paytable rows are longer than the " + std::to_string(MAX_ROWS) + " screen rows");
+        }
+
+        checkPaytable(errors);
+
+        for (const auto& item : symbolStructure.getWildSubstitutionMap()) {
+            checkSymbol(item.first, "wildSubs", errors);
+            for (const auto& sub : item.second) checkSymbol(sub, "wildSubs/" + item.first, errors);
+        }
+
+        for (const auto& item : allReelSets) {
+            const ReelSet& rs = item.second;
+            const std::string where = "reel set " + item.first;
+            for (size_t r = 0; r < rs.reels.size(); ++r) checkReel(rs.reels[r], where + " reel " + std::to_string(r + 1), errors);
+            if (rs.hasOverReel()) checkReel(*rs.getOverReel(), where + " overReel", errors);
+            if (rs.hasUnderReel()) checkReel(*rs.getUnderReel(), where + " underReel", errors);
+        }
+
+        checkReelSetNames(baseReelSetNames, "baseReelSets", errors);
+        checkReelSetNames(freeReelSetNames, "freeReelSets", errors);
+        if (findVariant(rtpKey) < 0) errors.push_back("game.RTP " + rtpKey + " has no reelWeights/reelWeightsFree entry");
+
+        std::unordered_set<std::string> reachable;
+        for (const auto& variant : rtpVariants) {
+            checkVariantWeights(baseReelSetNames, variant.reelWeights, "reelWeights/" + variant.rtpKey, reachable, errors);
+            checkVariantWeights(freeReelSetNames, variant.reelWeightsFree, "reelWeightsFree/" + variant.rtpKey, reachable, errors);
+        }
+        std::vector<std::string> unreachable;
+        for (const auto& item : allReelSets) {
+            if (!reachable.count(item.first)) unreachable.push_back(item.first);
+        }
+        std::sort(unreachable.begin(), unreachable.end());
+        for (const auto& name : unreachable) {
+            warnings.push_back("reel set " + name + " is never drawn (no RTP variant gives it weight > 0)");
+        }
+
+        if (flags.megaways) {
+            checkHeights(reelHeightPD, "reelHeights", errors);
+            checkHeights(reelHeightFreePD, "reelHeightsFree", errors);
+        }
+        for (size_t i = 0; i < boostOverPD.size(); ++i) checkDistribution(boostOverPD[i], "boost over " + std::to_string(i + 1), errors);
+        for (size_t i = 0; i < boostUnderPD.size(); ++i) checkDistribution(boostUnderPD[i], "boost under " + std::to_string(i + 1), errors);
+
+        if (!errors.empty()) {
+            std::string message = "Invalid game model (" + std::to_string(errors.size()) + " errors):";
+            for (const auto& e : errors) message += "\n  " + e;
+            throw std::invalid_argument(message);
+        }
+    }
+
+    // Every pays row covers lengths 1..numReels and all rows have the same length: a way can
+    // span every reel, and getPay() and the Stats hit tables index rows up to getWinLength()
+    void checkPaytable(std::vector<std::string>& errors) const {
+        const auto& rows = symbolStructure.getPaytableVec();
+        const auto& names = symbolStructure.getSymbols();
+        for (size_t id = 0; id < rows.size(); ++id) {
+            const size_t length = rows[id].size();
+            if (length < static_cast<size_t>(numReels)) {
+                errors.push_back("paytable.pays/" + names[id] + " has " + std::to_string(length) +
+                    " entries, game.reels is " + std::to_string(numReels));
+            }
+            else if (length != rows[0].size()) {
+                errors.push_back("paytable.pays/" + names[id] + " has " + std::to_string(length) +
+                    " entries, " + names[0] + " has " + std::to_string(rows[0].size()));
+            }
+        }
+    }
+
+    void checkSymbol(const std::string& name, const std::string& where, std::vector<std::string>& errors) const {
+        if (symbolStructure.findSymbolIndex(name) < 0) {
+            errors.push_back(where + ": symbol " + name + " is not in paytable.symbols");
+        }
+    }
+
+    // Strip symbols resolve, weights (if any) match the strip and give a positive total
+    void checkReel(const Reel& reel, const std::string& where, std::vector<std::string>& errors) const {
+        if (reel.symbols.empty()) errors.push_back(where + ": empty strip");
+        for (size_t i = 0; i < reel.symbols.size(); ++i) {
+            checkSymbol(reel.symbols[i], where + " stop " + std::to_string(i), errors);
+        }
+        if (reel.isWeighted()) {
+            if (reel.weights.size() != reel.symbols.size()) {
+                errors.push_back(where + ": " + std::to_string(reel.weights.size()) + " weights for " +
+                    std::to_string(reel.symbols.size()) + " stops");
+            }
+            checkWeights(reel.weights, where, errors);
+        }
+    }
+
+    static void checkWeights(const std::vector<int>& weights, const std::string& where, std::vector<std::string>& errors) {
+        long long total = 0;
+        for (int w : weights) {
+            if (w < 0) {
+                errors.push_back(where + ": negative weight " + std::to_string(w));
+                return;
+            }
+            total += w;
+        }
+        if (total <= 0) errors.push_back(where + ": weights sum to 0");
+        else if (total > INT_MAX) errors.push_back(where + ": weights sum past the 32-bit range");
+    }
+
+    static void checkDistribution(const PrizeDistribution<int>& pd, const std::string& where, std::vector<std::string>& errors) {
+        if (pd.getPrizes().size() != pd.getWeights().size()) {
+            errors.push_back(where + ": " + std::to_string(pd.getPrizes().size()) + " prizes but " +
+                std::to_string(pd.getWeights().size()) + " weights");
+        }
+        checkWeights(pd.getWeights(), where, errors);
+    }
+
+    // One height distribution per reel, each drawing 1..MAX_ROWS rows
+    void checkHeights(const std::vector<PrizeDistribution<int>>& pds, const std::string& key, std::vector<std::string>& errors) const {
+        if (pds.size() < static_cast<size_t>(numReels)) {
+            errors.push_back(key + ": " + std::to_string(pds.size()) + " distributions for " + std::to_string(numReels) + " reels");
+        }
+        for (size_t r = 0; r < pds.size(); ++r) {
+            const std::string where = key + " reel " + std::to_string(r + 1);
+            checkDistribution(pds[r], where, errors);
+            for (int rows : pds[r].getPrizes()) {
+                if (rows < 1 || rows > MAX_ROWS) {
+                    errors.push_back(where + ": height " + std::to_string(rows) + " outside 1.." + std::to_string(MAX_ROWS));
+                }
+            }
+        }
+    }
+
+    // Names exist and have numReels reels
+    void checkReelSetNames(const std::vector<std::string>& names, const std::string& key, std::vector<std::string>& errors) const {
+        for (const auto& name : names) {
+            auto it = allReelSets.find(name);
+            if (it == allReelSets.end()) {
+                errors.push_back(key + ": reel set " + name + " not found in reel_sets");
+            }
+            else if (it->second.reels.size() != static_cast<size_t>(numReels)) {
+                errors.push_back("reel set " + name + " has " + std::to_string(it->second.reels.size()) +
+                    " reels, game.reels is " + std::to_string(numReels));
+            }
+        }
+    }
+
+    // One weight per reel set of the table; sets with a positive weight go into `reachable`
+    static void checkVariantWeights(const std::vector<std::string>& names, const std::vector<int>& weights,
+        const std::string& where, std::unordered_set<std::string>& reachable, std::vector<std::string>& errors) {
+        if (names.size() != weights.size()) {
+            errors.push_back(where + ": " + std::to_string(weights.size()) + " weights for " +
+                std::to_string(names.size()) + " reel sets");
+        }
+        checkWeights(weights, where, errors);
+        for (size_t i = 0; i < names.size() && i < weights.size(); ++i) {
+            if (weights[i] > 0) reachable.insert(names[i]);
+        }
+    }
+
+    static std::vector<int> outcomeIndices(size_t n) {
+        std::vector<int> indices(n);
+        std::iota(indices.begin(), indices.end(), 0);
+        return indices;
+    }
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "GameModel.h"
+
+// Binary form of a compiled GameModel (--compile / --model). It holds the model's source
+// fields: game info, symbol table, reel strips as symbol ids, reel-set order, the weights of every RTP variant,
+// height and boost distributions. Loading is one bulk read and a linear decode with no JSON
+// involved; the model is then validated and its derived tables rebuilt exactly as from
+// config.json.
+//
+// Layout: "SLOTMODL", format version, byte-order mark, then the fields in the order of
+// save(). Integers are stored in host byte order, so a file only loads on a machine with
+// the same endianness; the byte-order mark rejects the others.
+class GameModelFile {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 2;
+
+    static void save(const GameModel& model, const std::string& path) {
+        Writer w;
+        w.bytes(magic(), MAGIC_SIZE);
+        w.pod<uint32_t>(FORMAT_VERSION);
+        w.pod<uint32_t>(BYTE_ORDER_MARK);
+
+        w.str(model.gameName);
+        w.str(model.modeLabel);
+        w.str(model.rtpKey);
+        w.pod<uint8_t>(model.flags.mode == GameMode::WAYS ? 0 : 1);
+        w.pod<uint8_t>(model.flags.cascades);
+        w.pod<uint8_t>(model.flags.megaways);
+        w.pod<int32_t>(model.numReels);
+        w.pod<int32_t>(model.cost);
+        w.strings(model.payHeaders);
+
+        const SymbolStructure& ss = model.symbolStructure;
+        w.strings(ss.getSymbols());
+        w.pod<uint32_t>(static_cast<uint32_t>(ss.getPaytableVec().size()));
+        for (const auto& row : ss.getPaytableVec()) w.vec(row);
+        w.pod<uint32_t>(static_cast<uint32_t>(ss.getWildSubstitutionMap().size()));
+        for (const auto& item : ss.getWildSubstitutionMap()) {
+            w.str(item.first);
+            w.strings(item.second);
+        }
+
+        w.pod<uint32_t>(static_cast<uint32_t>(model.allReelSets.size()));
+        for (const auto& item : model.allReelSets) {
+            const ReelSet& rs = item.second;
+            w.str(item.first);
+            w.str(MaskRegistry::name(rs.getMask()));
+            w.pod<uint32_t>(static_cast<uint32_t>(rs.reels.size()));
+            for (const auto& reel : rs.reels) writeReel(w, reel);
+            w.pod<uint8_t>(rs.hasOverReel());
+            if (rs.hasOverReel()) {
+                w.str(MaskRegistry::name(rs.getOverMask()));
+                writeReel(w, *rs.getOverReel());
+            }
+            w.pod<uint8_t>(rs.hasUnderReel());
+            if (rs.hasUnderReel()) {
+                w.str(MaskRegistry::name(rs.getUnderMask()));
+                writeReel(w, *rs.getUnderReel());
+            }
+        }
+
+        w.pod<uint32_t>(static_cast<uint32_t>(model.rtpVariants.size()));
+        for (const auto& variant : model.rtpVariants) {
+            w.str(variant.rtpKey);
+            w.vec(variant.reelWeights);
+            w.vec(variant.reelWeightsFree);
+        }
+        w.strings(model.baseReelSetNames);
+        w.strings(model.freeReelSetNames);
+        writeDistributions(w, model.reelHeightPD);
+        writeDistributions(w, model.reelHeightFreePD);
+        writeDistributions(w, model.boostOverPD);
+        writeDistributions(w, model.boostUnderPD);
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Failed to open " + path + " for writing");
+        file.write(w.data.data(), static_cast<std::streamsize>(w.data.size()));
+        if (!file) throw std::runtime_error("Failed to write " + path);
+    }
+
+    static std::shared_ptr<const GameModel> load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Failed to open " + path);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        const std::string data = contents.str();
+        Reader r(data, path);
+
+        char header[MAGIC_SIZE];
+        r.bytes(header, MAGIC_SIZE);
+        if (std::memcmp(header, magic(), MAGIC_SIZE) != 0) r.fail("not a compiled model");
+        const uint32_t version = r.pod<uint32_t>();
+        if (version != FORMAT_VERSION) {
+            r.fail("format version " + std::to_string(version) + ", expected " + std::to_string(FORMAT_VERSION));
+        }
+        if (r.pod<uint32_t>() != BYTE_ORDER_MARK) r.fail("written on a machine with a different byte order");
+
+        std::shared_ptr<GameModel> model(new GameModel());
+        model->gameName = r.str();
+        model->modeLabel = r.str();
+        model->rtpKey = r.str();
+        model->flags.mode = r.pod<uint8_t>() == 0 ? GameMode::WAYS : GameMode::LINES;
+        model->flags.cascades = r.pod<uint8_t>() != 0;
+        model->flags.megaways = r.pod<uint8_t>() != 0;
+        model->numReels = r.pod<int32_t>();
+        model->cost = r.pod<int32_t>();
+        model->payHeaders = r.strings();
+
+        const std::vector<std::string> symbols = r.strings();
+        std::vector<std::vector<int>> paytable(r.count(sizeof(uint32_t)));
+        for (auto& row : paytable) row = r.vec<int>();
+        std::unordered_map<std::string, std::vector<std::string>> wildSubs;
+        for (uint32_t n = r.pod<uint32_t>(); n > 0; --n) {
+            std::string wild = r.str();
+            wildSubs[wild] = r.strings();
+        }
+        model->symbolStructure = SymbolStructure(symbols, paytable, wildSubs);
+
+        for (uint32_t n = r.pod<uint32_t>(); n > 0; --n) {
+            const std::string name = r.str();
+            const std::string mask = r.str();
+            std::vector<Reel> reels;
+            for (uint32_t i = r.pod<uint32_t>(); i > 0; --i) reels.push_back(readReel(r, symbols));
+            std::unique_ptr<Reel> overReel, underReel;
+            std::string overMask, underMask;
+            if (r.pod<uint8_t>()) {
+                overMask = r.str();
+                overReel.reset(new Reel(readReel(r, symbols)));
+            }
+            if (r.pod<uint8_t>()) {
+                underMask = r.str();
+                underReel.reset(new Reel(readReel(r, symbols)));
+            }
+            model->allReelSets[name] = ReelSet(reels, mask, overReel.get(), overMask, underReel.get(), underMask);
+        }
+
+        model->rtpVariants.resize(r.count(3 * sizeof(uint32_t)));
+        for (auto& variant : model->rtpVariants) {
+            variant.rtpKey = r.str();
+            variant.reelWeights = r.vec<int>();
+            variant.reelWeightsFree = r.vec<int>();
+        }
+        model->baseReelSetNames = r.strings();
+        model->freeReelSetNames = r.strings();
+        model->reelHeightPD = readDistributions(r);
+        model->reelHeightFreePD = readDistributions(r);
+        model->boostOverPD = readDistributions(r);
+        model->boostUnderPD = readDistributions(r);
+        if (!r.atEnd()) r.fail("unexpected data after the model");
+
+        model->compileTables();
+        return model;
+    }
+
+private:
+    static constexpr size_t MAGIC_SIZE = 8;
+    static const char* magic() { return "SLOTMODL"; }
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Writer {
+        std::string data;
+
+        void bytes(const void* p, size_t n) { data.append(static_cast<const char*>(p), n); }
+
+        template <typename T>
+        void pod(T value) { bytes(&value, sizeof(T)); }
+
+        void str(const std::string& s) {
+            pod<uint32_t>(static_cast<uint32_t>(s.size()));
+            bytes(s.data(), s.size());
+        }
+
+        void strings(const std::vector<std::string>& v) {
+            pod<uint32_t>(static_cast<uint32_t>(v.size()));
+            for (const auto& s : v) str(s);
+        }
+
+        template <typename T>
+        void vec(const std::vector<T>& v) {
+            static_assert(std::is_trivially_copyable<T>::value, "raw vectors only");
+            pod<uint32_t>(static_cast<uint32_t>(v.size()));
+            if (!v.empty()) bytes(v.data(), v.size() * sizeof(T));
+        }
+    };
+
+    // Bounds-checked cursor over the file contents
+    class Reader {
+    public:
+        Reader(const std::string& data, const std::string& path)
+            : pos(data.data()), end(data.data() + data.size()), path(path) {}
+
+        void bytes(void* out, size_t n) {
+            if (static_cast<size_t>(end - pos) < n) fail("truncated");
+            std::memcpy(out, pos, n);
+            pos += n;
+        }
+
+        template <typename T>
+        T pod() { T value; bytes(&value, sizeof(T)); return value; }
+
+        std::string str() {
+            const uint32_t n = pod<uint32_t>();
+            if (static_cast<size_t>(end - pos) < n) fail("truncated");
+            std::string s(pos, n);
+            pos += n;
+            return s;
+        }
+
+        // Element count of a sequence, checked against the bytes left so a corrupt
+        // file cannot request a huge allocation
+        uint32_t count(size_t minBytesEach) {
+            const uint32_t n = pod<uint32_t>();
+            if (n > static_cast<size_t>(end - pos) / minBytesEach) fail("truncated");
+            return n;
+        }
+
+        std::vector<std::string> strings() {
+            std::vector<std::string> v(count(sizeof(uint32_t)));
+            for (auto& s : v) s = str();
+            return v;
+        }
+
+        template <typename T>
+        std::vector<T> vec() {
+            const uint32_t n = count(sizeof(T));
+            std::vector<T> v(n);
+            if (n) bytes(v.data(), n * sizeof(T));
+            return v;
+        }
+
+        bool atEnd() const { return pos == end; }
+
+        [[noreturn]] void fail(const std::string& what) const {
+            throw std::runtime_error("Invalid model file " + path + ": " + what);
+        }
+
+    private:
+        const char* pos;
+        const char* end;
+        std::string path;
+    };
+
+    // Strips are stored as symbol ids; names come back from the symbol table
+    static void writeReel(Writer& w, const Reel& reel) {
+        w.vec(reel.ids);
+        w.vec(reel.weights);
+    }
+
+    static Reel readReel(Reader& r, const std::vector<std::string>& symbols) {
+        const std::vector<SymbolId> ids = r.vec<SymbolId>();
+        std::vector<std::string> names;
+        names.reserve(ids.size());
+        for (SymbolId id : ids) {
+            if (id >= symbols.size()) r.fail("reel symbol id out of range");
+            names.push_back(symbols[id]);
+        }
+        return Reel(names, r.vec<int>());
+    }
+
+    static void writeDistributions(Writer& w, const std::vector<PrizeDistribution<int>>& pds) {
+        w.pod<uint32_t>(static_cast<uint32_t>(pds.size()));
+        for (const auto& pd : pds) {
+            w.str(pd.getMaskName());
+            w.vec(pd.getPrizes());
+            w.vec(pd.getWeights());
+        }
+    }
+
+    static std::vector<PrizeDistribution<int>> readDistributions(Reader& r) {
+        std::vector<PrizeDistribution<int>> pds(r.count(3 * sizeof(uint32_t)));
+        for (auto& pd : pds) {
+            const std::string mask = r.str();
+            const std::vector<int> prizes = r.vec<int>();
+            pd = PrizeDistribution<int>(mask, prizes, r.vec<int>());
+        }
+        return pds;
+    }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+// Streaming central moments of a sample (Welford update, Chan/Pebay pairwise merge).
+// Holds count, mean, M2..M4 and max, so per-thread accumulators merge exactly without
+// keeping the individual values or a histogram.
+class MomentAccumulator {
+public:
+    void add(double x) {
+        const double n1 = static_cast<double>(n);
+        ++n;
+        const double delta = x - mean;
+        const double deltaN = delta / n;
+        const double deltaN2 = deltaN * deltaN;
+        const double term1 = delta * deltaN * n1;
+        mean += deltaN;
+        M4 += term1 * deltaN2 * (static_cast<double>(n) * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * M2 - 4.0 * deltaN * M3;
+        M3 += term1 * deltaN * (n - 2.0) - 3.0 * deltaN * M2;
+        M2 += term1;
+        if (x > maxValue) maxValue = x;
+    }
+
+    void merge(const MomentAccumulator& other) {
+        if (other.n == 0) return;
+        if (n == 0) { *this = other; return; }
+
+        const double na = static_cast<double>(n), nb = static_cast<double>(other.n);
+        const double nt = na + nb;
+        const double delta = other.mean - mean;
+        const double delta2 = delta * delta;
+        const double delta3 = delta2 * delta;
+        const double delta4 = delta2 * delta2;
+
+        const double m2 = M2 + other.M2 + delta2 * na * nb / nt;
+        const double m3 = M3 + other.M3 + delta3 * na * nb * (na - nb) / (nt * nt)
+            + 3.0 * delta * (na * other.M2 - nb * M2) / nt;
+        const double m4 = M4 + other.M4 + delta4 * na * nb * (na * na - na * nb + nb * nb) / (nt * nt * nt)
+            + 6.0 * delta2 * (na * na * other.M2 + nb * nb * M2) / (nt * nt)
+            + 4.0 * delta * (na * other.M3 - nb * M3) / nt;
+
+        mean += delta * nb / nt;
+        M2 = m2;
+        M3 = m3;
+        M4 = m4;
+        n += other.n;
+        if (other.maxValue > maxValue) maxValue = other.maxValue;
+    }
+
+    long long count() const { return n; }
+    double getMean() const { return mean; }
+    double getMax() const { return n ? maxValue : 0.0; }
+
+    // Population variance, matching the histogram-based StDev
+    double variance() const { return n ? M2 / n : 0.0; }
+    double standardDeviation() const { return std::sqrt(variance()); }
+
+    double skewness() const {
+        return M2 > 0 ? std::sqrt(static_cast<double>(n)) * M3 / std::pow(M2, 1.5) : 0.0;
+    }
+
+    // Excess kurtosis (0 for a normal distribution)
+    double kurtosis() const {
+        return M2 > 0 ? static_cast<double>(n) * M4 / (M2 * M2) - 3.0 : 0.0;
+    }
+
+private:
+    long long n = 0;
+    double mean = 0.0;
+    double M2 = 0.0, M3 = 0.0, M4 = 0.0;
+    double maxValue = -std::numeric_limits<double>::infinity();
+};
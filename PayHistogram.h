@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+// Frequency table of pays in whole credits. Pays below DENSE_LIMIT are counted in a flat
+// array; the rare larger ones go to overflow buckets kept sorted by pay. Iteration is in
+// increasing pay order, and merging two histograms is a linear sweep. The dense array is
+// allocated on first use unless an owner that must not allocate while counting (the spin
+// loop's Stats) asks for it up front with allocateDense().
+class PayHistogram {
+public:
+    static constexpr long long DENSE_LIMIT = 4096;
+
+    // Pays are integral credit amounts; anything else is rounded to the nearest credit
+    static long long toCredits(double pay) { return std::llround(pay); }
+
+    void add(double pay, long long count = 1) { addCredits(toCredits(pay), count); }
+
+    void addCredits(long long pay, long long count = 1) {
+        if (pay >= 0 && pay < DENSE_LIMIT) {
+            if (dense.empty()) dense.assign(DENSE_LIMIT, 0);
+            dense[static_cast<size_t>(pay)] += count;
+            return;
+        }
+        auto it = std::lower_bound(overflow.begin(), overflow.end(), pay,
+            [](const std::pair<long long, long long>& bucket, long long p) { return bucket.first < p; });
+        if (it != overflow.end() && it->first == pay) it->second += count;
+        else overflow.insert(it, std::make_pair(pay, count));
+    }
+
+    // Allocates the dense array now instead of on the first add below DENSE_LIMIT
+    void allocateDense() {
+        if (dense.empty()) dense.assign(DENSE_LIMIT, 0);
+    }
+
+    // Room for overflowBuckets distinct values above DENSE_LIMIT before the buckets reallocate
+    void reserveOverflow(size_t overflowBuckets) {
+        overflow.reserve(overflowBuckets);
+    }
+
+    void merge(const PayHistogram& other) {
+        if (!other.dense.empty()) {
+            if (dense.empty()) dense.assign(DENSE_LIMIT, 0);
+            for (size_t i = 0; i < dense.size(); ++i) dense[i] += other.dense[i];
+        }
+        if (other.overflow.empty()) return;
+
+        std::vector<std::pair<long long, long long>> merged;
+        merged.reserve(overflow.size() + other.overflow.size());
+        auto a = overflow.cbegin();
+        auto b = other.overflow.cbegin();
+        while (a != overflow.cend() || b != other.overflow.cend()) {
+            if (b == other.overflow.cend() || (a != overflow.cend() && a->first < b->first)) merged.push_back(*a++);
+            else if (a == overflow.cend() || b->first < a->first) merged.push_back(*b++);
+            else { merged.emplace_back(a->first, a->second + b->second); ++a; ++b; }
+        }
+        overflow.swap(merged);
+    }
+
+    // Calls fn(pay, count) for every pay seen, in increasing pay order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        auto it = overflow.begin();
+        for (; it != overflow.end() && it->first < 0; ++it) fn(it->first, it->second);
+        for (size_t i = 0; i < dense.size(); ++i) {
+            if (dense[i]) fn(static_cast<long long>(i), dense[i]);
+        }
+        for (; it != overflow.end(); ++it) fn(it->first, it->second);
+    }
+
+    long long totalCount() const {
+        long long n = 0;
+        forEach([&](long long, long long c) { n += c; });
+        return n;
+    }
+
+    // Smallest recorded value v with at least a fraction q of the counts at or below v
+    long long quantile(double q) const {
+        const long long total = totalCount();
+        if (total == 0) return 0;
+        const long long rank = std::max(1LL, static_cast<long long>(std::ceil(q * total)));
+        long long seen = 0, result = 0;
+        bool found = false;
+        forEach([&](long long value, long long c) {
+            if (found) return;
+            seen += c;
+            if (seen >= rank) { result = value; found = true; }
+        });
+        return result;
+    }
+
+    // Population standard deviation of the recorded pays
+    double standardDeviation() const {
+        double mean = 0.0, totalWeight = 0.0;
+        forEach([&](long long pay, long long c) { mean += static_cast<double>(pay) * c; totalWeight += c; });
+        if (totalWeight == 0.0) return 0.0;
+        mean /= totalWeight;
+
+        double variance = 0.0;
+        forEach([&](long long pay, long long c) { variance += c * (pay - mean) * (pay - mean); });
+        return std::sqrt(variance / totalWeight);
+    }
+
+private:
+    std::vector<long long> dense;
+    std::vector<std::pair<long long, long long>> overflow;  // sorted by pay
+};
@@ -9,8 +9,10 @@ template <typename PrizeType>
 class PrizeDistribution {
 private:
     std::string maskName;
+    MaskId maskId = -1;
     std::vector<PrizeType> prizes;
     std::vector<int> weights;
+    WeightTable table; // built from weights; rebuilt whenever they change
 
 public:
     // Default constructor
@@ -18,20 +20,14 @@ public:
 
     // Constructor with parameters
     PrizeDistribution(const std::string& mask, const std::vector<PrizeType>& prizeList, const std::vector<int>& weightList)
-        : maskName(mask), prizes(prizeList), weights(weightList) {}
+        : maskName(mask), maskId(MaskRegistry::intern(mask)), prizes(prizeList), weights(weightList), table(weightList) {}
 
-    PrizeType getRandomPrize() const {
-        // Calculate total weight
-        int totalWeight = 0;
-        for (int weight : weights) {
-            totalWeight += weight;
-        }
-
-        // Choose a random number
-        int randIndex = getRandFromDist(maskName, weights);
+    // Constructor with an already interned mask
+    PrizeDistribution(MaskId mask, const std::vector<PrizeType>& prizeList, const std::vector<int>& weightList)
+        : maskName(MaskRegistry::name(mask)), maskId(mask), prizes(prizeList), weights(weightList), table(weightList) {}
 
-        // Return the corresponding prize
-        return prizes[randIndex];
+    PrizeType getRandomPrize() const {
+        return prizes[table.sample(maskId)];
     }
 
     // Change Prizes
@@ -40,12 +36,13 @@ public:
     void setPrize(int index, const PrizeType& newPrize) { prizes[index] = newPrize; }
 
     // Change Weights
-    void setWeights(const std::vector<int>& newWeights) { weights = newWeights; }
+    void setWeights(const std::vector<int>& newWeights) { weights = newWeights; table = WeightTable(weights); }
     // Change Weights by index
-    void setWeight(int index, int newWeight) { weights[index] = newWeight; }
+    void setWeight(int index, int newWeight) { weights[index] = newWeight; table = WeightTable(weights); }
 
     // Getters
     const std::vector<PrizeType>& getPrizes() const { return prizes; }
     const std::vector<int>& getWeights() const { return weights; }
+    const std::string& getMaskName() const { return maskName; }
 };
 
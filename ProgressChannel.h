@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "MomentAccumulator.h"
+
+// Merged view of all workers' latest snapshots
+struct ProgressSnapshot {
+    long long spins = 0;
+    long long hitSpins = 0;
+    std::vector<double> mean;   // per pay header
+    std::vector<double> m2;     // per pay header, sum of squared deviations
+
+    // Standard error of a header's mean pay
+    double standardError(size_t header) const {
+        return spins > 1 ? std::sqrt(m2[header] / spins) / std::sqrt(static_cast<double>(spins)) : 0.0;
+    }
+};
+
+// Lock-free progress channel for RANDOM_MODE. Every worker owns one slot and publishes
+// its running totals into it under a sequence lock; the reporter thread reads all slots
+// without blocking the workers, and retries a slot that was being written.
+class ProgressChannel {
+public:
+    ProgressChannel(int numWorkers, size_t numHeaders) : headers(numHeaders) {
+        for (int i = 0; i < numWorkers; ++i) slots.emplace_back(new Slot(numHeaders));
+    }
+
+    // Called by worker `worker` only
+    void publish(int worker, long long spins, long long hitSpins, const std::vector<MomentAccumulator>& moments) {
+        Slot& s = *slots[worker];
+        const unsigned seq = s.seq.load(std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.spins.store(spins, std::memory_order_relaxed);
+        s.hitSpins.store(hitSpins, std::memory_order_relaxed);
+        for (size_t h = 0; h < headers; ++h) {
+            s.mean[h].store(moments[h].getMean(), std::memory_order_relaxed);
+            s.m2[h].store(moments[h].variance() * moments[h].count(), std::memory_order_relaxed);
+        }
+        s.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    ProgressSnapshot collect() const {
+        ProgressSnapshot total;
+        total.mean.assign(headers, 0.0);
+        total.m2.assign(headers, 0.0);
+        std::vector<double> mean(headers), m2(headers);
+
+        for (const auto& slot : slots) {
+            const Slot& s = *slot;
+            long long spins, hits;
+            unsigned before, after;
+            do {
+                before = s.seq.load(std::memory_order_acquire);
+                spins = s.spins.load(std::memory_order_relaxed);
+                hits = s.hitSpins.load(std::memory_order_relaxed);
+                for (size_t h = 0; h < headers; ++h) {
+                    mean[h] = s.mean[h].load(std::memory_order_relaxed);
+                    m2[h] = s.m2[h].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = s.seq.load(std::memory_order_relaxed);
+            } while ((before & 1u) || before != after);
+
+            if (spins == 0) continue;
+            // Chan's pairwise merge of (count, mean, M2)
+            const double na = static_cast<double>(total.spins), nb = static_cast<double>(spins);
+            for (size_t h = 0; h < headers; ++h) {
+                const double delta = mean[h] - total.mean[h];
+                total.m2[h] += m2[h] + delta * delta * na * nb / (na + nb);
+                total.mean[h] += delta * nb / (na + nb);
+            }
+            total.spins += spins;
+            total.hitSpins += hits;
+        }
+        return total;
+    }
+
+    void requestStop() { stop.store(true, std::memory_order_relaxed); }
+    bool stopRequested() const { return stop.load(std::memory_order_relaxed); }
+
+    // One progress line: spins, rate, ETA, hit rate and RTP +/- 95% CI per header
+    static std::string format(const ProgressSnapshot& p, const std::vector<std::string>& headerNames,
+        double cost, long long totalSpins, double elapsedSeconds) {
+        const double rate = elapsedSeconds > 0 ? p.spins / elapsedSeconds : 0.0;
+        const double eta = rate > 0 ? (totalSpins - p.spins) / rate : 0.0;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+            << "[progress] " << p.spins << "/" << totalSpins << " spins ("
+            << 100.0 * p.spins / std::max(1LL, totalSpins) << "%), "
+            << rate / 1e6 << "M spins/s, ETA " << std::setprecision(0) << eta << " s, hit "
+            << std::setprecision(2) << (p.spins ? 100.0 * p.hitSpins / p.spins : 0.0) << "%";
+        line << std::setprecision(5);
+        for (size_t h = 0; h < headerNames.size() && h < p.mean.size(); ++h) {
+            line << " | " << headerNames[h] << ' ' << p.mean[h] / cost
+                << " +/- " << 1.96 * p.standardError(h) / cost;
+        }
+        return line.str();
+    }
+
+private:
+    // Heap-allocated one by one; the padding keeps neighbouring slots off each other's cache line
+    struct Slot {
+        char padBefore[64];
+        std::atomic<unsigned> seq{ 0 };
+        std::atomic<long long> spins{ 0 };
+        std::atomic<long long> hitSpins{ 0 };
+        std::unique_ptr<std::atomic<double>[]> mean;
+        std::unique_ptr<std::atomic<double>[]> m2;
+        char padAfter[64];
+
+        explicit Slot(size_t numHeaders)
+            : mean(new std::atomic<double>[numHeaders]), m2(new std::atomic<double>[numHeaders]) {
+            for (size_t h = 0; h < numHeaders; ++h) {
+                mean[h].store(0.0, std::memory_order_relaxed);
+                m2[h].store(0.0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    size_t headers;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::atomic<bool> stop{ false };
+};
@@ -22,7 +22,7 @@ std::vector<std::vector<json>> RandomLogGenerator::roundScales;
 std::vector<std::vector<int>> RandomLogGenerator::roundMultipliers;
 std::vector<std::vector<double>> RandomLogGenerator::roundWheelBonusPrizes;
 std::vector<double> RandomLogGenerator::currentSpinTumbleWins;
-std::vector<RandTriple> RandomLogGenerator::randomLogInstructions;
+ReplayCursor RandomLogGenerator::replayCursor;
 
 // Method definitions
 void RandomLogGenerator::setMaxRoundWin(double maxWin) { maxRoundWin = maxWin; }
@@ -53,7 +53,7 @@ bool RandomLogGenerator::handleLoggingMode(LogMode mode, const std::string& rand
     if (logMode == REPLAY) {
         readAndParseLog(randomLogFileName);
         gameDetailsFile.open(gameDetailsFileName);
-        return !randomLogInstructions.empty();
+        return !replayCursor.empty();
     }
 
     return false;
@@ -205,49 +205,13 @@ void RandomLogGenerator::addWheelBonusPrizes(std::vector<double>& wheelBonusPriz
 }
 
 void RandomLogGenerator::readAndParseLog(const std::string& filename) {
-    std::ifstream file(filename);
-    std::string line;
-
-    if (!file.is_open()) {
+    if (!replayCursor.open(filename)) {
         throw std::runtime_error("Could not open the log file: " + filename);
     }
-
-    randomLogInstructions.clear();
-    while (std::getline(file, line)) {
-        std::vector<RandTriple> entries;
-        parseLogLine(line, entries);
-        randomLogInstructions.insert(randomLogInstructions.end(), entries.begin(), entries.end());
-    }
 }
 
-std::vector<RandTriple> RandomLogGenerator::getRandomLogInstructions() {
-    return randomLogInstructions;
+const RandTriple* RandomLogGenerator::nextReplayInstruction() {
+    const RandTriple* instruction = replayCursor.next();
+    if (instruction) ++instructionIndex;
+    return instruction;
 }
-
-void RandomLogGenerator::parseLogLine(const std::string& line, std::vector<RandTriple>& entries) {
-    std::stringstream ss(line);
-    std::string token;
-    while (std::getline(ss, token, ';')) {
-        std::stringstream tokenStream(token);
-        std::string part;
-        while (std::getline(tokenStream, part, '#')) {
-            if (part.empty()) continue;
-            std::vector<std::string> randTriples;
-            std::stringstream randTripleStream(part);
-            while (std::getline(randTripleStream, part, ',')) {
-                randTriples.push_back(part);
-            }
-            for (const auto& randTriple : randTriples) {
-                std::vector<std::string> parts;
-                std::stringstream randTripleSS(randTriple);
-                while (std::getline(randTripleSS, part, ':')) {
-                    parts.push_back(part);
-                }
-                if (parts.size() == 3) {
-                    RandTriple entry{ parts[0], std::stoi(parts[1]), std::stoi(parts[2]) };
-                    entries.push_back(entry);
-                }
-            }
-        }
-    }
-}
\ No newline at end of file
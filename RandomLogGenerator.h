@@ -27,11 +27,83 @@ enum LogMode {
 enum SimulationMode {
     RANDOM_MODE,
     PLAYER_MODE,
-    CSV_MODE
+    CSV_MODE,
+    EXACT_MODE
 };
 extern LogMode logMode;
 extern int instructionIndex;  // Index for replaying randoms
 
+// Forward-only reader over a random log for REPLAY. The file is loaded with one bulk read and
+// triples are parsed on demand, so serving a draw is O(1) and the instruction stream is never
+// copied. Tokens are separated by ',', ';', '#' or line breaks; win amounts ("#0.12") are skipped.
+class ReplayCursor {
+public:
+    bool open(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg(0, std::ios::end);
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        if (!buffer.empty()) file.read(&buffer[0], buffer.size());
+        offset = 0;
+        served = 0;
+        return true;
+    }
+
+    bool empty() const { return buffer.empty(); }
+
+    // Next triple in the log, or nullptr once the log is exhausted
+    const RandTriple* next() {
+        while (offset < buffer.size()) {
+            size_t end = buffer.find_first_of(",;#\r\n", offset);
+            if (end == std::string::npos) end = buffer.size();
+            const bool parsed = parseTriple(offset, end);
+            offset = end + 1;
+            if (parsed) {
+                ++served;
+                return &current;
+            }
+        }
+        return nullptr;
+    }
+
+    // Number of triples served so far
+    size_t position() const { return served; }
+
+private:
+    std::string buffer;
+    size_t offset = 0;
+    size_t served = 0;
+    RandTriple current;
+
+    bool parseInt(size_t begin, size_t end, int& value) const {
+        if (begin >= end) return false;
+        bool negative = buffer[begin] == '-';
+        if (negative && ++begin >= end) return false;
+        long long v = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (buffer[i] < '0' || buffer[i] > '9') return false;
+            v = v * 10 + (buffer[i] - '0');
+        }
+        value = static_cast<int>(negative ? -v : v);
+        return true;
+    }
+
+    // mask:result:range
+    bool parseTriple(size_t begin, size_t end) {
+        size_t c1 = buffer.find(':', begin);
+        if (c1 == std::string::npos || c1 >= end) return false;
+        size_t c2 = buffer.find(':', c1 + 1);
+        if (c2 == std::string::npos || c2 >= end) return false;
+        int result, range;
+        if (!parseInt(c1 + 1, c2, result) || !parseInt(c2 + 1, end, range)) return false;
+        current.mask.assign(buffer, begin, c1 - begin);
+        current.result = result;
+        current.range = range;
+        return true;
+    }
+};
+
 class RandomLogGenerator {
 public:
     // File streams for logging
@@ -61,7 +133,7 @@ public:
     // static bool loggingEnabled;
 
      // For replay mode
-    static std::vector<RandTriple> randomLogInstructions;
+    static ReplayCursor replayCursor;
 
     // Method declarations
     static void setMaxRoundWin(double maxWin);       // Set the maximum round win
@@ -89,16 +161,12 @@ public:
 
     // Replay-related methods
     static void readAndParseLog(const std::string& filename);
-    static std::vector<RandTriple> getRandomLogInstructions();
+    static const RandTriple* nextReplayInstruction();  // nullptr once the log is exhausted
 
 
     static bool handleLoggingMode(LogMode mode, const std::string& randomLogFileName, const std::string& gameDetailsFileName);
 
 
-
-private:
-    static void parseLogLine(const std::string& line, std::vector<RandTriple>& entries);
-
 };
 
 // Method Definitions
@@ -116,7 +184,7 @@ double RandomLogGenerator::maxRoundWin = std::numeric_limits<double>::max();  //
 bool RandomLogGenerator::maxWinTriggered = false;
 std::vector<std::vector<json>> RandomLogGenerator::roundScreens;
 std::vector<std::vector<json>> RandomLogGenerator::roundScales;
-std::vector<RandTriple> RandomLogGenerator::randomLogInstructions;
+ReplayCursor RandomLogGenerator::replayCursor;
 //LogMode logMode;
 int instructionIndex = 0;
 std::vector<std::vector<int>> RandomLogGenerator::roundMultipliers;
@@ -160,7 +228,7 @@ bool RandomLogGenerator::handleLoggingMode(LogMode mode, const std::string& rand
         readAndParseLog(randomLogFileName);  // Read the log file for replay
         // Open only the gameDetailsFile for writing in REPLAY mode
         gameDetailsFile.open(gameDetailsFileName);
-        return !randomLogInstructions.empty();
+        return !replayCursor.empty();
     }
 
     if (logMode == NO_LOGGING) {
@@ -370,56 +438,15 @@ void RandomLogGenerator::addWheelBonusPrizes(std::vector<double>& wheelBonusPriz
 }
 
 void RandomLogGenerator::readAndParseLog(const std::string& filename) {
-    std::ifstream file(filename);
-    std::string line;
-
-    if (!file.is_open()) {
+    if (!replayCursor.open(filename)) {
         throw std::runtime_error("Could not open the log file: " + filename);
     }
-
-    randomLogInstructions.clear();
-
-    while (std::getline(file, line)) {
-        std::vector<RandTriple> entries;
-        parseLogLine(line, entries);
-        randomLogInstructions.insert(randomLogInstructions.end(), entries.begin(), entries.end());
-    }
-}
-
-std::vector<RandTriple> RandomLogGenerator::getRandomLogInstructions() {
-    return randomLogInstructions;
 }
 
-void RandomLogGenerator::parseLogLine(const std::string& line, std::vector<RandTriple>& entries) {
-    std::stringstream ss(line);
-    std::string token;
-
-    while (std::getline(ss, token, ';')) {
-        std::stringstream tokenStream(token);
-        std::string part;
-
-        while (std::getline(tokenStream, part, '#')) {
-            if (part.empty()) {
-                continue;
-            }
-            std::vector<std::string> randTriples;
-            std::stringstream randTripleStream(part);
-            while (std::getline(randTripleStream, part, ',')) {
-                randTriples.push_back(part);
-            }
-            for (const auto& randTriple : randTriples) {
-                std::vector<std::string> parts;
-                std::stringstream randTripleSS(randTriple);
-                while (std::getline(randTripleSS, part, ':')) {
-                    parts.push_back(part);
-                }
-                if (parts.size() == 3) {
-                    RandTriple entry{ parts[0], std::stoi(parts[1]), std::stoi(parts[2]) };
-                    entries.push_back(entry);
-                }
-            }
-        }
-    }
+const RandTriple* RandomLogGenerator::nextReplayInstruction() {
+    const RandTriple* instruction = replayCursor.next();
+    if (instruction) ++instructionIndex;
+    return instruction;
 }
 
 #endif // RANDOMLOGGENERATOR_H
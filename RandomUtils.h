@@ -7,74 +7,196 @@
 #include <limits>
 
 #include <random>
+#include <algorithm>
 #include <numeric>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 #include "RandomLogGenerator.h" // Include if you use RandomLogGenerator in these functions
 
 extern int instructionIndex; // Same for instructionIndex if it's used globally
 
-// Fast xorshift64* RNG suitable for non-crypto uses; lightweight and very fast.
-struct XorShift64Star {
-    using result_type = uint64_t;
-    explicit XorShift64Star(uint64_t seed = 0) { if (seed == 0) seed = 0x9e3779b97f4a7c15ULL ^ 1; state = seed; }
+extern uint64_t rngMasterSeed; // Master seed shared by every worker; defined in main.cpp
+
+// Philox4x32-10 counter-based RNG (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// Every output is a pure function of (key, stream, position), so any stream can be entered at any
+// position in O(1) and streams with different ids never overlap.
+struct Philox4x32 {
+    using result_type = uint32_t;
+
+    explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) { reseed(seed, stream); }
+
+    // Select the key and stream, rewinding to the first output of that stream
+    void reseed(uint64_t seed, uint64_t stream) {
+        key[0] = static_cast<uint32_t>(seed);
+        key[1] = static_cast<uint32_t>(seed >> 32);
+        seek(stream, 0);
+    }
+
+    // Jump to output number `pos` of `stream` under the current key
+    void seek(uint64_t stream, uint64_t pos) {
+        streamId = stream;
+        position = pos;
+        bufferedBlock = ~0ULL;
+    }
+
+    // Skip ahead n outputs in O(1)
+    void discard(unsigned long long n) { position += n; }
+
     result_type operator()() {
-        uint64_t x = state;
-        x ^= x >> 12;
-        x ^= x << 25;
-        x ^= x >> 27;
-        state = x;
-        return x * 2685821657736338717ULL;
-    }
-    static constexpr result_type min() { return 0ULL; }
+        const uint64_t block = position >> 2;
+        if (block != bufferedBlock) {
+            generateBlock(block);
+        }
+        return buffer[position++ & 3];
+    }
+
+    uint64_t getStream() const { return streamId; }
+    uint64_t getPosition() const { return position; }
+
+    static constexpr result_type min() { return 0U; }
     static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
 private:
-    uint64_t state;
+    uint32_t key[2];
+    uint64_t streamId = 0;
+    uint64_t position = 0;      // index of the next 32-bit output within the stream
+    uint64_t bufferedBlock = ~0ULL;
+    uint32_t buffer[4];
+
+    static inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+        const uint64_t p = static_cast<uint64_t>(a) * b;
+        hi = static_cast<uint32_t>(p >> 32);
+        lo = static_cast<uint32_t>(p);
+    }
+
+    // Counter layout: words 0-1 hold the block index, words 2-3 hold the stream id
+    void generateBlock(uint64_t block) {
+        uint32_t ctr[4] = { static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+                            static_cast<uint32_t>(streamId), static_cast<uint32_t>(streamId >> 32) };
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint32_t hi0, lo0, hi1, lo1;
+            mulhilo(0xD2511F53U, ctr[0], hi0, lo0);
+            mulhilo(0xCD9E8D57U, ctr[2], hi1, lo1);
+            ctr[0] = hi1 ^ ctr[1] ^ k0;
+            ctr[1] = lo1;
+            ctr[2] = hi0 ^ ctr[3] ^ k1;
+            ctr[3] = lo0;
+            k0 += 0x9E3779B9U;
+            k1 += 0xBB67AE85U;
+        }
+        for (int i = 0; i < 4; ++i) buffer[i] = ctr[i];
+        bufferedBlock = block;
+    }
 };
 
-// Thread-local fast RNG accessor: seeds once per thread and reuses the engine for all calls.
-inline XorShift64Star& getThreadRng() {
-    static thread_local XorShift64Star gen([]() -> uint64_t {
-        std::random_device rd;
-        uint64_t a = static_cast<uint64_t>(rd());
-        uint64_t b = static_cast<uint64_t>(rd());
-        return (a << 32) | b;
-    }());
+// Unbiased draw in [0, range) (Lemire's multiply-shift with rejection); identical on every platform,
+// unlike std::uniform_int_distribution whose algorithm is implementation-defined.
+inline uint32_t boundedRand(Philox4x32& gen, uint32_t range) {
+    uint64_t m = static_cast<uint64_t>(gen()) * range;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < range) {
+        const uint32_t threshold = (0U - range) % range;
+        while (low < threshold) {
+            m = static_cast<uint64_t>(gen()) * range;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+// Thread-local RNG accessor: one engine per thread, repositioned by beginRandomStream().
+inline Philox4x32& getThreadRng() {
+    static thread_local Philox4x32 gen(rngMasterSeed, 0);
     return gen;
 }
 
+// Enter the stream owned by one game round. Streams are keyed by the global spin index, so a run
+// produces the same results however its spins are split across threads, and any shard can be
+// replayed on its own by starting at its first spin index.
+inline void beginRandomStream(uint64_t stream) {
+    getThreadRng().reseed(rngMasterSeed, stream);
+}
+
+// Integer handle for an RNG mask name
+using MaskId = int;
+
+// Registry of RNG mask names. Masks are interned once while the game is loaded; the spin loop only
+// passes the integer id, and the name is looked up only when a draw is logged or replayed.
+class MaskRegistry {
+public:
+    static MaskId intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto& ids = idsByName();
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        MaskId id = static_cast<MaskId>(names().size());
+        names().push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    // Intern "base_0" .. "base_{count-1}"
+    static std::vector<MaskId> internIndexed(const std::string& base, int count) {
+        std::vector<MaskId> ids;
+        ids.reserve(count);
+        for (int i = 0; i < count; ++i) ids.push_back(intern(base + "_" + std::to_string(i)));
+        return ids;
+    }
+
+    static const std::string& name(MaskId id) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        return names()[id];
+    }
+
+private:
+    static std::mutex& registryMutex() { static std::mutex m; return m; }
+    static std::deque<std::string>& names() { static std::deque<std::string> n; return n; } // stable references
+    static std::unordered_map<std::string, MaskId>& idsByName() { static std::unordered_map<std::string, MaskId> m; return m; }
+};
+
 // Define a method to generate random numbers within a specified range
-inline int getRand(const std::string& mask, int range) {
+inline int getRand(MaskId mask, int range) {
     int index;
+    const RandTriple* replayed = nullptr;
     if (logMode == REPLAY) {
-        std::vector<RandTriple> randomLogInstructions = RandomLogGenerator::getRandomLogInstructions();
-        RandTriple currentInstruction = randomLogInstructions[instructionIndex++];
-        if (instructionIndex >= randomLogInstructions.size()) {
+        replayed = RandomLogGenerator::nextReplayInstruction();
+        if (!replayed) {
             std::cout << "Error: End of log file" << std::endl;
             logMode = NO_LOGGING;
         }
-        if (currentInstruction.mask != mask)
+    }
+    if (replayed) {
+        const RandTriple& currentInstruction = *replayed;
+        const std::string& maskName = MaskRegistry::name(mask);
+        if (currentInstruction.mask != maskName)
             std::cout << "Error: Mask mismatch  " << currentInstruction.mask + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(currentInstruction.range) <<
-            " vs " << mask + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(range) << std::endl;
+            " vs " << maskName + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(range) << std::endl;
         else if (currentInstruction.range != range)
             std::cout << "Error: Range mismatch  " << currentInstruction.mask + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(currentInstruction.range) <<
-            " vs " << mask + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(range) << std::endl;
+            " vs " << maskName + ":" + std::to_string(currentInstruction.result) + ":" + std::to_string(range) << std::endl;
         index = currentInstruction.result;
     }
     else {
-        // Use a thread-local fast RNG seeded once per thread and reuse it across calls.
-        XorShift64Star& gen = getThreadRng();
-        std::uniform_int_distribution<> dis(0, range - 1);
-        index = static_cast<int>(dis(gen));
-        if (logMode == 1) {
-            RandTriple randTriple = { mask, index, range };
+        // Draw from the current round's stream of the thread-local counter-based RNG.
+        index = static_cast<int>(boundedRand(getThreadRng(), static_cast<uint32_t>(range)));
+        if (logMode == LOGGING) {
+            RandTriple randTriple = { MaskRegistry::name(mask), index, range };
             RandomLogGenerator::addRandom(randTriple);
         }
     }
     return index;
 }
 
+// Convenience overload for one-off callers; hot paths should intern their mask up front
+inline int getRand(const std::string& mask, int range) {
+    return getRand(MaskRegistry::intern(mask), range);
+}
+
 // Function to convert a discrete distribution into a uniform distribution,
 // choose a random number, and output the chosen number, total weight, and chosen index
-inline int getRandFromDist(const std::string& mask, const std::vector<int>& distribution) {
+inline int getRandFromDist(MaskId mask, const std::vector<int>& distribution) {
     int totalWeight = std::accumulate(distribution.begin(), distribution.end(), 0);
     int rnd = getRand(mask, totalWeight);
     int index = 0;
@@ -89,18 +211,76 @@ inline int getRandFromDist(const std::string& mask, const std::vector<int>& dist
     return index;
 }
 
-// New method to randomly choose r positions from n
-inline std::vector<int> getRandomPositions(const std::string& mask, int n, int r) {
+inline int getRandFromDist(const std::string& mask, const std::vector<int>& distribution) {
+    return getRandFromDist(MaskRegistry::intern(mask), distribution);
+}
+
+// Precomputed sampler for a fixed integer weight vector. Draws consume exactly one
+// getRand(mask, totalWeight) value and map it to the same index as getRandFromDist, so random
+// logs and replays are unchanged; the cumulative scan is replaced by a guide table (Chen's
+// indexed search) that jumps straight to the right neighbourhood, giving O(1) expected lookups.
+class WeightTable {
+public:
+    WeightTable() = default;
+
+    explicit WeightTable(const std::vector<int>& weights) {
+        cumulative.reserve(weights.size());
+        long long sum = 0;
+        for (int w : weights) {
+            sum += w;
+            cumulative.push_back(static_cast<int>(sum));
+        }
+        totalWeight = static_cast<int>(sum);
+
+        // guide[b] = first index whose cumulative weight exceeds the start of bucket b
+        const size_t buckets = std::max<size_t>(1, weights.size());
+        guide.resize(buckets);
+        size_t index = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            const long long bucketStart = static_cast<long long>(b) * totalWeight / buckets;
+            while (index + 1 < cumulative.size() && cumulative[index] <= bucketStart) ++index;
+            guide[b] = static_cast<int>(index);
+        }
+    }
+
+    bool empty() const { return cumulative.empty(); }
+    int getTotalWeight() const { return totalWeight; }
+    size_t size() const { return cumulative.size(); }
+
+    // Map a uniform value in [0, totalWeight) to its index
+    int indexFor(int rnd) const {
+        const size_t bucket = static_cast<size_t>(static_cast<long long>(rnd) * guide.size() / totalWeight);
+        size_t index = guide[bucket];
+        while (cumulative[index] <= rnd) ++index;
+        return static_cast<int>(index);
+    }
+
+    int sample(MaskId mask) const {
+        return indexFor(getRand(mask, totalWeight));
+    }
+
+private:
+    std::vector<int> cumulative;
+    std::vector<int> guide;
+    int totalWeight = 0;
+};
+
+// New method to randomly choose r positions from n; masks[i] is used for the i-th pick
+inline std::vector<int> getRandomPositions(const std::vector<MaskId>& masks, int n, int r) {
     std::vector<int> positions(n);
     std::iota(positions.begin(), positions.end(), 0);
 
     std::vector<int> chosenPositions;
     for (int i = 0; i < r; ++i) {
-        int chosenIndex = getRand(mask + "_" + std::to_string(i), n - i);
+        int chosenIndex = getRand(masks[i], n - i);
         chosenPositions.push_back(positions[chosenIndex]);
         std::swap(positions[chosenIndex], positions[n - i - 1]);
     }
 
     return chosenPositions;
 }
+
+inline std::vector<int> getRandomPositions(const std::string& mask, int n, int r) {
+    return getRandomPositions(MaskRegistry::internIndexed(mask, r), n, r);
+}
 #endif // RANDOM_UTILS_H
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "GameInstance.h"
+#include "ProgressChannel.h"
+
+// RANDOM_MODE over several RTP variants in one process (--rtp-variants). The variants share
+// one compiled model, so strips, symbols and distributions are loaded once; only the
+// reel-set weights differ. Work units are (variant, batch) pairs handed out from a single
+// counter in round-robin order, so every variant advances at the same pace over the same
+// worker pool. Batch b of each variant covers the same global spin indices as batch b of a
+// single-variant run, so a variant's results are identical to running it alone with the
+// same seed.
+//
+// The same spin index means the same RNG stream, so the variants already share common
+// random numbers. Draws map monotonically to outcomes (multiply-shift, then the inverse
+// CDF of WeightTable), so a spin picks the same heights and usually the same reel set and
+// stops under every variant, and diverges only where the weights move a boundary. With
+// --paired a work unit is one batch played by every variant in turn. The first variant
+// records each spin's total pay, and the others accumulate their per-spin difference from
+// it. The paired difference has a far smaller variance than the difference of two
+// independent runs.
+class RtpSweep {
+public:
+    struct Options {
+        long long spins = 0;        // per variant
+        long long firstSpin = 0;
+        long long batchSpins = 1;
+        int threads = 1;
+        bool payHistograms = true;
+        double progressSeconds = 0.0;
+        double targetCi = 0.0;      // stop once every variant's Total RTP CI half-width is below this;
+                                    // paired runs stop on the half-width of each difference instead
+        long long minSpinsBeforeStop = 0;
+        bool paired = false;        // common random numbers: per-spin difference from the first variant
+    };
+
+    RtpSweep(std::shared_ptr<const GameModel> gameModel, std::vector<size_t> variantIndices,
+             SymbolStructure& symbolStructure, const std::vector<std::string>& rtpHeads, double costPerSpin)
+        : model(std::move(gameModel)), variants(std::move(variantIndices)),
+          symbolStructure(symbolStructure), rtpHeads(rtpHeads), costPerSpin(costPerSpin) {}
+
+    // Variant indices for a --rtp-variants list: comma-separated keys, or "all". Besides the
+    // RTP keys, configs keep diagnostic weight profiles (low, high, one per reel set); "all"
+    // takes the keys ending in '%' when there are any, other profiles can be named directly.
+    // The first variant listed is the reference of a --paired run.
+    static std::vector<size_t> parseVariantList(const GameModel& model, const std::string& list) {
+        std::vector<size_t> indices;
+        if (list == "all") {
+            for (size_t v = 0; v < model.rtpVariants.size(); ++v) {
+                const std::string& key = model.rtpVariants[v].rtpKey;
+                if (!key.empty() && key.back() == '%') indices.push_back(v);
+            }
+            if (indices.empty()) {
+                for (size_t v = 0; v < model.rtpVariants.size(); ++v) indices.push_back(v);
+            }
+            return indices;
+        }
+
+        std::istringstream keys(list);
+        std::string key;
+        while (std::getline(keys, key, ',')) {
+            if (key.empty()) continue;
+            const int v = model.findVariant(key);
+            if (v < 0) throw std::invalid_argument("Unknown RTP variant: " + key);
+            if (std::find(indices.begin(), indices.end(), static_cast<size_t>(v)) == indices.end()) {
+                indices.push_back(static_cast<size_t>(v));
+            }
+        }
+        if (indices.empty()) throw std::invalid_argument("Empty RTP variant list");
+        return indices;
+    }
+
+    const std::vector<size_t>& getVariants() const { return variants; }
+    const std::string& variantKey(size_t i) const { return model->rtpVariants[variants[i]].rtpKey; }
+
+    // Plays every variant and returns its aggregated Stats, in the order of getVariants()
+    std::vector<std::shared_ptr<Stats>> run(const Options& opt) {
+        const size_t numVariants = variants.size();
+        const int numThreads = std::max(1, opt.threads);
+        const long long numBatches = (opt.spins + opt.batchSpins - 1) / opt.batchSpins;
+        const long long numVariantsLL = static_cast<long long>(numVariants);
+        const long long numUnits = opt.paired ? numBatches : numBatches * numVariantsLL;
+        std::atomic<long long> nextUnit(0);
+
+        // perThreadStats[t][v]: written only by worker t until the join
+        std::vector<std::vector<std::shared_ptr<Stats>>> perThreadStats(numThreads);
+        std::vector<std::vector<MomentAccumulator>> perThreadDiffs(numThreads, std::vector<MomentAccumulator>(numVariants));
+        std::vector<std::vector<long long>> perThreadIdentical(numThreads, std::vector<long long>(numVariants, 0));
+        std::vector<std::unique_ptr<ProgressChannel>> progress;
+        for (size_t v = 0; v < numVariants; ++v) progress.emplace_back(new ProgressChannel(numThreads, rtpHeads.size()));
+        // Paired runs: header v carries the moments of variant v minus the first variant
+        ProgressChannel pairedProgress(numThreads, numVariants);
+        const bool pairedStop = opt.paired && numVariants > 1;
+        std::atomic<bool> stop(false);
+        std::atomic<int> workersRunning(numThreads);
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < numThreads; ++t) {
+            for (size_t v = 0; v < numVariants; ++v) {
+                auto statsPtr = std::make_shared<Stats>(symbolStructure, rtpHeads, costPerSpin);
+                statsPtr->setSingleWriter(true);
+                statsPtr->setTrackPayFrequencies(opt.payHistograms);
+                perThreadStats[t].push_back(statsPtr);
+            }
+
+            workers.emplace_back([&, t]() {
+                // One instance per variant for the worker's lifetime; a unit only repositions it
+                std::vector<std::unique_ptr<GameInstance>> instances;
+                for (size_t v = 0; v < numVariants; ++v) {
+                    instances.emplace_back(new GameInstance(model, *perThreadStats[t][v], variants[v]));
+                }
+                std::vector<long long> played(numVariants, 0);
+                std::vector<double> referencePays(opt.paired ? opt.batchSpins : 0); // per spin of the batch, first variant
+
+                long long unit;
+                while (!stop.load(std::memory_order_relaxed) && (unit = nextUnit.fetch_add(1)) < numUnits) {
+                    // Unpaired: units are (batch, variant) round-robin. Paired: a unit is a batch for every variant.
+                    const size_t firstVariant = opt.paired ? 0 : static_cast<size_t>(unit % numVariantsLL);
+                    const size_t endVariant = opt.paired ? numVariants : firstVariant + 1;
+                    const long long begin = (opt.paired ? unit : unit / numVariantsLL) * opt.batchSpins;
+                    const long long count = std::min(opt.batchSpins, opt.spins - begin);
+
+                    for (size_t v = firstVariant; v < endVariant; ++v) {
+                        Stats& s = *perThreadStats[t][v];
+                        GameInstance& instance = *instances[v];
+                        instance.setSpinIndex(opt.firstSpin + begin);
+                        if (!opt.paired) {
+                            instance.playBaseGame(count);
+                        }
+                        else {
+                            for (long long i = 0; i < count; ++i) {
+                                instance.playBaseGame(1);
+                                const double pay = s.getLastSpinPayout();
+                                if (v == 0) {
+                                    referencePays[i] = pay;
+                                    continue;
+                                }
+                                perThreadDiffs[t][v].add(pay - referencePays[i]);
+                                if (pay == referencePays[i]) ++perThreadIdentical[t][v];
+                            }
+                        }
+                        played[v] += count;
+                        progress[v]->publish(t, played[v], s.getHitSpins(), s.getPayMoments());
+                    }
+                    if (pairedStop) pairedProgress.publish(t, played[0], 0, perThreadDiffs[t]);
+                }
+                for (size_t v = 0; v < numVariants; ++v) perThreadStats[t][v]->setNumIterations(played[v]);
+                --workersRunning;
+                });
+        }
+
+        // One progress line per variant; the early stop waits for the slowest-converging one
+        std::thread reporter;
+        if (opt.progressSeconds > 0 || opt.targetCi > 0) {
+            reporter = std::thread([&]() {
+                const auto t0 = std::chrono::steady_clock::now();
+                double nextReport = opt.progressSeconds;
+                while (workersRunning.load() > 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                    const bool report = opt.progressSeconds > 0 && now >= nextReport;
+                    bool allConverged = opt.targetCi > 0;
+                    for (size_t v = 0; v < numVariants; ++v) {
+                        const ProgressSnapshot snap = progress[v]->collect();
+                        const double halfWidth = 1.96 * snap.standardError(rtpHeads.size() - 1) / costPerSpin;
+                        if (!pairedStop && (snap.spins < opt.minSpinsBeforeStop || halfWidth >= opt.targetCi)) allConverged = false;
+                        if (report) {
+                            std::cerr << '[' << variantKey(v) << "] "
+                                      << ProgressChannel::format(snap, rtpHeads, costPerSpin, opt.spins, now) << std::endl;
+                        }
+                    }
+                    if (pairedStop) {
+                        const ProgressSnapshot diffs = pairedProgress.collect();
+                        for (size_t v = 1; v < numVariants; ++v) {
+                            const double halfWidth = 1.96 * diffs.standardError(v) / costPerSpin;
+                            if (diffs.spins < opt.minSpinsBeforeStop || halfWidth >= opt.targetCi) allConverged = false;
+                            if (report) {
+                                std::cerr << std::fixed << std::setprecision(5) << '[' << variantKey(v) << " - " << variantKey(0)
+                                          << "] [progress] paired Total RTP difference " << diffs.mean[v] / costPerSpin
+                                          << " +/- " << halfWidth << std::defaultfloat << std::endl;
+                            }
+                        }
+                    }
+                    if (report) nextReport += opt.progressSeconds;
+                    if (allConverged && !stop.load()) {
+                        std::cerr << (pairedStop ? "[progress] 95% CI half-width of every paired Total RTP difference is below the target "
+                                                 : "[progress] Total RTP 95% CI half-width of every variant is below the target ")
+                                  << opt.targetCi << ", stopping early" << std::endl;
+                        stop.store(true);
+                    }
+                }
+                });
+        }
+
+        for (auto& th : workers) th.join();
+        if (reporter.joinable()) reporter.join();
+
+        pairedDiffs.assign(numVariants, MomentAccumulator());
+        pairedIdentical.assign(numVariants, 0);
+        for (int t = 0; t < numThreads; ++t) {
+            for (size_t v = 0; v < numVariants; ++v) {
+                pairedDiffs[v].merge(perThreadDiffs[t][v]);
+                pairedIdentical[v] += perThreadIdentical[t][v];
+            }
+        }
+
+        std::vector<std::shared_ptr<Stats>> results;
+        for (size_t v = 0; v < numVariants; ++v) {
+            auto total = std::make_shared<Stats>(symbolStructure, rtpHeads, costPerSpin);
+            total->setTrackPayFrequencies(opt.payHistograms);
+            for (int t = 0; t < numThreads; ++t) total->aggregate(*perThreadStats[t][v]);
+            total->calculateStandardDeviations();
+            results.push_back(total);
+        }
+        return results;
+    }
+
+    // Consolidated table: one row per variant with the RTP of every pay header, the Total
+    // RTP 95% CI half-width, total StDev (credits) and hit rate
+    void writeReport(const std::vector<std::shared_ptr<Stats>>& results, std::ostream& out) const {
+        out << "RTP Variant Sweep\n";
+        out << "Variant\tSpins";
+        for (const auto& head : rtpHeads) out << '\t' << head;
+        out << "\t95% CI\tStDev\tHit Freq\n";
+        for (size_t v = 0; v < results.size(); ++v) {
+            const std::vector<MomentAccumulator>& moments = results[v]->getPayMoments();
+            const MomentAccumulator& total = moments.back();
+            const double n = static_cast<double>(total.count());
+            out << variantKey(v) << '\t' << total.count();
+            for (double pay : results[v]->getPayTotals()) out << '\t' << std::fixed << std::setprecision(6) << rtpOf(pay, n);
+            const double halfWidth = n > 1 ? 1.96 * total.standardDeviation() / std::sqrt(n) / costPerSpin : 0.0;
+            out << '\t' << halfWidth << '\t' << std::setprecision(4) << total.standardDeviation()
+                << '\t' << std::setprecision(6) << (n > 0 ? results[v]->getHitSpins() / n : 0.0) << '\n';
+            out.unsetf(std::ios::fixed);
+        }
+        out << "----------------------------------------\n";
+        if (results.size() > 1 && pairedDiffs.size() == results.size() && pairedDiffs[1].count() > 0) {
+            writePairedReport(results, out);
+        }
+    }
+
+    // Total RTP of each variant minus the first one, paired spin by spin. The independent
+    // CI is what two separate runs of the same length would give; Variance Reduction is the
+    // ratio of the two variances, i.e. how many times fewer spins the paired estimate needs.
+    // Identical Pays is the share of spins with the same total pay under both variants.
+    void writePairedReport(const std::vector<std::shared_ptr<Stats>>& results, std::ostream& out) const {
+        const MomentAccumulator& reference = results[0]->getPayMoments().back();
+        out << "Paired Differences vs " << variantKey(0) << " (common random numbers)\n";
+        out << "Variant\tSpins\tRTP Diff\tPaired 95% CI\tIndependent 95% CI\tVariance Reduction\tIdentical Pays\n";
+        for (size_t v = 1; v < results.size(); ++v) {
+            const MomentAccumulator& d = pairedDiffs[v];
+            const MomentAccumulator& total = results[v]->getPayMoments().back();
+            const double n = static_cast<double>(d.count());
+            const double independentVariance = total.variance() + reference.variance();
+            const double pairedHalfWidth = n > 1 ? 1.96 * d.standardDeviation() / std::sqrt(n) / costPerSpin : 0.0;
+            const double independentHalfWidth = n > 1 ? 1.96 * std::sqrt(independentVariance / n) / costPerSpin : 0.0;
+            const double diff = rtpOf(results[v]->getPayTotals().back(), n) - rtpOf(results[0]->getPayTotals().back(), n);
+            out << variantKey(v) << '\t' << d.count() << std::fixed << std::setprecision(6)
+                << '\t' << diff << '\t' << pairedHalfWidth << '\t' << independentHalfWidth
+                << '\t' << std::setprecision(2) << (d.variance() > 0 ? independentVariance / d.variance() : 0.0)
+                << '\t' << std::setprecision(6) << (n > 0 ? pairedIdentical[v] / n : 0.0) << '\n';
+            out.unsetf(std::ios::fixed);
+        }
+        out << "----------------------------------------\n";
+    }
+
+private:
+    double rtpOf(double totalPay, double spins) const { return spins > 0 ? totalPay / (spins * costPerSpin) : 0.0; }
+
+    std::shared_ptr<const GameModel> model;
+    std::vector<size_t> variants;
+    SymbolStructure& symbolStructure;
+    std::vector<std::string> rtpHeads;
+    double costPerSpin;
+    std::vector<MomentAccumulator> pairedDiffs;  // per variant, pay minus the first variant's (paired runs)
+    std::vector<long long> pairedIdentical;      // per variant, spins paying the same as the first variant
+};
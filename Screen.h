@@ -3,115 +3,167 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <iomanip>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
 #include "RandomLogGenerator.h"
 #include "Symbols.h"
+#include "SymbolKernels.h"
 
 
 
 using namespace std;
 using json = nlohmann::json;
 
-struct SideCell {
-    std::string name;
-    bool boosted = false;
-};
+// Per-symbol counts of one reel, indexed by SymbolId
+using SymbolHistogram = std::array<uint8_t, MAX_SYMBOLS>;
+// (length, ways) per SymbolId
+using WaysTable = std::array<std::pair<int, int>, MAX_SYMBOLS>;
 
 class Screen {
-private:
-    int numReels;
-    int maxHeight;
-    std::vector<int> heights;
-    vector<vector<std::string>> grid;
-	// For over/under reels
+public:
     static constexpr int SIDE_LEN = 4;          // middle-four reels
-    //std::array<std::string, SIDE_LEN> overRow{}; // index 0 ⟶ reel 1, 3 ⟶ reel 4
-    //std::array<std::string, SIDE_LEN> underRow{}; 
-    std::array<SideCell, SIDE_LEN> overRow{};  
-    std::array<SideCell, SIDE_LEN> underRow{};
+
+private:
+    static constexpr int OVER_OFFSET = MAX_REELS * MAX_ROWS;      // over row cells follow the reels
+    static constexpr int UNDER_OFFSET = OVER_OFFSET + SIDE_LEN;   // then the under row
+    static constexpr int NUM_CELLS = 64;        // whole screen in one cache line
+
+    int numReels = 0;
+    int maxHeight = 0;
+    std::array<int, MAX_REELS> heights{};
+    // Column-major symbol ids: reel r occupies cells [r * MAX_ROWS, r * MAX_ROWS + MAX_ROWS),
+    // cells beyond a reel's height and unused padding hold EMPTY_SYMBOL.
+    alignas(64) std::array<SymbolId, NUM_CELLS> cells;
+	// For over/under reels: index 0 -> reel 1, 3 -> reel 4
+    std::array<bool, SIDE_LEN> overBoosted{};
+    std::array<bool, SIDE_LEN> underBoosted{};
+
+    std::array<uint64_t, MAX_REELS> reelCellMask{}; // cells of each reel in `cells`, side cells included
+    const SymbolStructure* symbolStructure = nullptr; // names for display / logging only
+    uint64_t wildMask = 0;
+
+    SymbolId& cell(int reel, int row) { return cells[reel * MAX_ROWS + row]; }
+    SymbolId cell(int reel, int row) const { return cells[reel * MAX_ROWS + row]; }
+    SymbolId& sideCell(bool over, int idx) { return cells[(over ? OVER_OFFSET : UNDER_OFFSET) + idx]; }
+    SymbolId sideCell(bool over, int idx) const { return cells[(over ? OVER_OFFSET : UNDER_OFFSET) + idx]; }
+    bool& sideBoost(bool over, int idx) { return (over ? overBoosted : underBoosted)[idx]; }
+
+    static int lowestBit(uint64_t m) {
+        int b = 0;
+        while (!(m & 1ULL)) { m >>= 1; ++b; }
+        return b;
+    }
+
+    std::string symbolName(SymbolId id) const {
+        if (id == EMPTY_SYMBOL) return "";
+        return symbolStructure ? symbolStructure->getSymbolName(id) : std::to_string(id);
+    }
 
 public:
     std::vector<std::pair<int, int>> markedPositions;
 
     // Default constructor
-    Screen() {}
+    Screen() {
+        cells.fill(EMPTY_SYMBOL);
+        for (int r = 0; r < MAX_REELS; ++r) setReelHeight(r, 0);
+    }
 
     // Constructor for screen with equal rows
-    Screen(int _numReels, int _numRows) : numReels(_numReels), maxHeight(_numRows) {
-        heights.reserve(_numReels);
-        for (int i = 0; i < _numReels; ++i) {
-			heights.push_back(_numRows); // Initialize all reels with the same height
-		}
-        // Initialize the grid with placeholders
-        resize(heights);
+    Screen(int _numReels, int _numRows) {
+        cells.fill(EMPTY_SYMBOL);
+        resize(_numReels, _numRows);
     }
 
     // Constructor for screen with variable heights
-    Screen(const std::vector<int>& _heights) : numReels(_heights.size()), heights(_heights) {
-        resize(heights);
+    Screen(const std::vector<int>& _heights) {
+        cells.fill(EMPTY_SYMBOL);
+        resize(_heights);
 	}
 
+    // Symbol table used for names and the wild mask
+    void setSymbolStructure(const SymbolStructure* ss) {
+        symbolStructure = ss;
+        wildMask = ss ? ss->getWildMask() : 0;
+    }
 
     // For over/under reels
     inline bool middleReel(int reel) const { return reel >= 1 && reel <= 4; }
 
-    inline bool match(const std::string& symbol, const std::string& target, bool includeWild = true) const {
-        if (includeWild && (symbol == target || symbol == "WL")) return true;
-        return symbol == target;
+    inline bool isWild(SymbolId symbol) const { return symbol < MAX_SYMBOLS && ((wildMask >> symbol) & 1ULL); }
+
+    inline bool match(SymbolId symbol, SymbolId target, bool includeWild = true) const {
+        return symbol == target || (includeWild && isWild(symbol));
 	}
 
-    void setSideSymbol(bool over, int idx, const std::string& s, bool boosted = false) {
-        auto& cell = (over ? overRow : underRow)[idx];
-        cell.name = s;
-        cell.boosted = boosted;
+    void setSideSymbol(bool over, int idx, SymbolId s, bool boosted = false) {
+        sideCell(over, idx) = s;
+        sideBoost(over, idx) = boosted;
     }
 
-    std::string getSideSymbol(bool over, int idx) const {
-        return (over ? overRow : underRow)[idx].name;
+    SymbolId getSideSymbol(bool over, int idx) const {
+        return sideCell(over, idx);
     }
 
     // Optional explicit boost accessors if you want them:
     bool isSideBoosted(bool over, int idx) const {
-        return (over ? overRow : underRow)[idx].boosted;
+        return (over ? overBoosted : underBoosted)[idx];
     }
     void setSideBoosted(bool over, int idx, bool b) {
-        (over ? overRow : underRow)[idx].boosted = b;
+        sideBoost(over, idx) = b;
     }
 
-
-    // add symbols to over/under reels from ReelSet
- /*   void addSideSymbols(bool over, const ReelSet& rs, std::vector<bool> boostVec = { 0,0,0,0 }) {
-        const auto& strip = rs.reels[0].symbols;
-        for (int i = 0; i < SIDE_LEN; ++i)
-            setSideSymbol(over, i, strip[(rs.currentIndices[0] + i) % strip.size()], boostVec[i]);
-    }
-*/
+    // Raw cell block (reels, then over row, then under row) for the evaluators
+    const SymbolId* data() const { return cells.data(); }
 
     // Resize the screen based on fixed number of rows
     void resize(int _numReels, int _numRows) {
+        if (_numReels > MAX_REELS || _numRows > MAX_ROWS) throw std::invalid_argument("Screen exceeds max reels/rows");
 		numReels = _numReels;
 		maxHeight = _numRows;
-		heights.resize(numReels, _numRows); // Initialize all reels with the same height
-		grid.resize(numReels, vector<string>(_numRows, "")); // Initialize the grid with empty strings
+        for (int r = 0; r < MAX_REELS; ++r) setReelHeight(r, r < numReels ? _numRows : 0);
 	}
 
     // Resize the screen with variable heights
-    void resize(std::vector<int> newH) {
-		heights = newH; // Update the heights vector with the new heights
-		numReels = heights.size(); // Update the number of reels based on the new heights
-        grid.resize(numReels);
+    void resize(const std::vector<int>& newH) {
+        resize(newH.data(), static_cast<int>(newH.size()));
+    }
+
+    // Same from a plain array of count heights, so per-spin callers need no vector
+    void resize(const int* newH, int count) {
+        if (count > MAX_REELS) throw std::invalid_argument("Screen exceeds max reels");
+		numReels = count; // Update the number of reels based on the new heights
         maxHeight = 0;
-        // Resize each inner vector to have _numRows elements
-        for (int i = 0; i < numReels; ++i) {
-            if (heights[i] > maxHeight) {
-				maxHeight = heights[i]; // Update maxHeight if the current reel's height is greater
+        for (int r = 0; r < MAX_REELS; ++r) {
+            setReelHeight(r, r < numReels ? newH[r] : 0);
+            if (heights[r] > maxHeight) {
+				maxHeight = heights[r]; // Update maxHeight if the current reel's height is greater
 			}
-            grid[i].resize(heights[i], ""); // Ensure all new elements are initialized to empty strings
         }
     }
 
-    void setReelHeight(int r, int h) { heights[r] = h; grid[r].resize(h); }
+    // Back to the state of a newly constructed Screen(_numReels, 0); markedPositions keeps its capacity
+    void reset(int _numReels) {
+        cells.fill(EMPTY_SYMBOL);
+        overBoosted.fill(false);
+        underBoosted.fill(false);
+        markedPositions.clear();
+        resize(_numReels, 0);
+    }
+
+    // Cells above the new height are cleared so they never match a symbol
+    void setReelHeight(int r, int h) {
+        if (h > MAX_ROWS) throw std::invalid_argument("Screen exceeds max rows");
+        for (int row = h; row < heights[r]; ++row) cell(r, row) = EMPTY_SYMBOL;
+        heights[r] = h;
+        uint64_t mask = ((1ULL << h) - 1) << (r * MAX_ROWS);
+        if (middleReel(r)) mask |= (1ULL << (OVER_OFFSET + r - 1)) | (1ULL << (UNDER_OFFSET + r - 1));
+        reelCellMask[r] = mask;
+    }
 
     int getReelHeight(int r) const { return heights[r]; }
+    int getNumReels() const { return numReels; }
 
 
     void display(bool displayMarkedPositions = false) {
@@ -131,15 +183,14 @@ public:
                         }
                     }
                     if (marked) {
-                       cout << setw(5) << "[" << grid[j][i] << "] ";
-//cout << setw(5) << ("[" + grid[j][i] + "]");
+                       cout << setw(5) << "[" << symbolName(cell(j, i)) << "] ";
                     }
                     else {
-                        cout << setw(5) << grid[j][i] << "  ";
+                        cout << setw(5) << symbolName(cell(j, i)) << "  ";
                     }
                 }
                 else {
-                    cout << setw(5) << grid[j][i] << "  ";
+                    cout << setw(5) << symbolName(cell(j, i)) << "  ";
                 }
             }
             cout << endl;
@@ -147,9 +198,9 @@ public:
     }
 
     // Function to update a cell in the screen with a new symbol
-    void updateCell(int reel, int row, const std::string& symbol) {
+    void updateCell(int reel, int row, SymbolId symbol) {
         if (row >= 0 && row < heights[reel] && reel >= 0 && reel < numReels) {
-            grid[reel][row] = symbol;
+            cell(reel, row) = symbol;
         }
     }
 
@@ -157,63 +208,40 @@ public:
     void clearScreen() {
         for (int i = 0; i < numReels; ++i) {
             for (int j = 0; j < heights[i]; ++j) {
-                grid[i][j] = "";
+                cell(i, j) = EMPTY_SYMBOL;
             }
         }
     }
 
-    //// Function to fill the screen with symbols from spinning reel sets
-    //void fillScreen(const vector<vector<string>>& spinResults) {
-    //    // Clear the screen
-    //    clearScreen();
-
-    //    // Fill the screen with symbols from spinResults
-    //    for (int i = 0; i < min(numReels, (int)spinResults[i].size()); ++i) { 
-    //        for (int j = 0; j < min(heights[i], (int)spinResults.size()); ++j) {
-    //            grid[i][j] = spinResults[i][j];
-    //        }
-    //    }
-    //}
-
     // Method to generate the screen based on the chosen indices for spinning the reels
-    void generateScreen(ReelSet& reelSet) {
-        clearScreen();
+    void generateScreen(const ReelCursor& reelSet) {
         for (int reelIndex = 0; reelIndex < numReels; ++reelIndex) {
+            const auto& strip = reelSet.reel(reelIndex).ids;
+            const int n = static_cast<int>(strip.size());
+            int currentIndex = reelSet.currentIndices[reelIndex] % n;
             for (int rowIndex = 0; rowIndex < heights[reelIndex]; ++rowIndex) {
-                int currentIndex = (reelSet.currentIndices[reelIndex] + rowIndex) % reelSet.reels[reelIndex].symbols.size();
-                updateCell(reelIndex, rowIndex, reelSet.reels[reelIndex].symbols[currentIndex]);
+                cell(reelIndex, rowIndex) = strip[currentIndex];
+                if (++currentIndex == n) currentIndex = 0;
             }
         }
     }
 
 
     // Function to count the number of times a symbol appears on a reel
-    int countSymbolOnReel(int reelIndex, const string& symbol, bool includeWild = true) const {
-        if (reelIndex < 0 || reelIndex >= numReels) {
+    int countSymbolOnReel(int reelIndex, SymbolId symbol, bool includeWild = true) const {
+        if (reelIndex < 0 || reelIndex >= numReels || symbol == EMPTY_SYMBOL) {
             //  cerr << "Invalid reel index" << endl;
             return 0;
         }
         int count = 0;
-        //for (int i = 0; i < heights[reelIndex]; ++i) {
-        //    if (includeWild) {
-        //        if (grid[reelIndex][i] == symbol || grid[reelIndex][i] == "WL") {
-        //            ++count;
-        //        }
-        //    }
-        //    else {
-        //        if (grid[reelIndex][i] == symbol) {
-        //            ++count;
-        //        }
-        //    }
-        //}
         // 1) vertical column
         for (int row = 0; row < heights[reelIndex]; ++row) {
-            if (match(grid[reelIndex][row], symbol, includeWild)) ++count;
+            if (match(cell(reelIndex, row), symbol, includeWild)) ++count;
         }
         // 2) side rows
         if (middleReel(reelIndex)) {
-            if (match(overRow[reelIndex - 1].name, symbol, includeWild)) ++count;
-            if (match(underRow[reelIndex - 1].name, symbol, includeWild)) ++count;
+            if (match(sideCell(true, reelIndex - 1), symbol, includeWild)) ++count;
+            if (match(sideCell(false, reelIndex - 1), symbol, includeWild)) ++count;
         }
         return count;
     }
@@ -221,7 +249,7 @@ public:
    
 
     // Function to count the number of times a symbol appears on the screen
-    int countSymbolOnScreen(const string& symbol, bool includeWild = true) const {
+    int countSymbolOnScreen(SymbolId symbol, bool includeWild = true) const {
         int count = 0;
         for (int i = 0; i < numReels; ++i) {
             count += countSymbolOnReel(i, symbol, includeWild);
@@ -230,7 +258,7 @@ public:
     }
 
     // Function to count the length and number of ways for a given symbol
-    pair<int, int> getWaysForSymbol(const string& symbol)const {
+    pair<int, int> getWaysForSymbol(SymbolId symbol)const {
         int length = 0;
         int ways = 1;
         for (int i = 0; i < numReels; ++i) {
@@ -248,6 +276,83 @@ public:
         return make_pair(length, ways);
     }
 
+    // Raw per-symbol counts of one reel, side-row cells included (wilds not folded in)
+    void countReelSymbols(int reelIndex, SymbolHistogram& hist) const {
+        hist.fill(0);
+        for (int row = 0; row < heights[reelIndex]; ++row) {
+            const SymbolId s = cell(reelIndex, row);
+            if (s != EMPTY_SYMBOL) ++hist[s];
+        }
+        if (middleReel(reelIndex)) {
+            const SymbolId over = sideCell(true, reelIndex - 1);
+            const SymbolId under = sideCell(false, reelIndex - 1);
+            if (over != EMPTY_SYMBOL) ++hist[over];
+            if (under != EMPTY_SYMBOL) ++hist[under];
+        }
+    }
+
+    // Length and ways of every symbol id below numSymbols. The SIMD kernel builds one match
+    // mask per symbol over the whole cell block; wild cells are OR'ed into every mask, so a
+    // reel's count is the popcount of the mask restricted to that reel.
+    void getWaysForAllSymbols(int numSymbols, WaysTable& out) const {
+        getWaysForAllSymbols(numSymbols, out, SymbolKernels::matchMasks());
+    }
+
+    // Same with an explicit match-mask kernel; SelfCheck runs every kernel the CPU has
+    // against getWaysForAllSymbolsScalar through this
+    void getWaysForAllSymbols(int numSymbols, WaysTable& out, SymbolKernels::MatchMaskFn kernel) const {
+        uint64_t masks[MAX_SYMBOLS];
+        kernel(cells.data(), numSymbols, masks);
+
+        uint64_t wildCells = 0;
+        for (int s = 0; s < numSymbols; ++s) {
+            if (isWild(static_cast<SymbolId>(s))) wildCells |= masks[s];
+        }
+        for (int s = 0; s < numSymbols; ++s) {
+            const uint64_t m = masks[s] | wildCells;
+            int length = 0;
+            int ways = 1;
+            for (int i = 0; i < numReels; ++i) {
+                const int count = SymbolKernels::popcount64(m & reelCellMask[i]);
+                if (count == 0) break;
+                ++length;
+                ways *= count;
+            }
+            out[s] = make_pair(length, length ? ways : 0);
+        }
+    }
+
+    // Scalar evaluator: one histogram pass per reel. Same result as calling getWaysForSymbol
+    // for each symbol: a wild counts towards every symbol, and a wild target also counts the
+    // other wilds.
+    void getWaysForAllSymbolsScalar(int numSymbols, WaysTable& out) const {
+        SymbolHistogram hist;
+        int alive = numSymbols;     // symbols still connected from the left
+        for (int s = 0; s < numSymbols; ++s) out[s] = make_pair(0, 1);
+
+        for (int i = 0; i < numReels && alive > 0; ++i) {
+            countReelSymbols(i, hist);
+            int wilds = 0;
+            for (uint64_t m = wildMask; m; m &= m - 1) wilds += hist[lowestBit(m)];
+
+            for (int s = 0; s < numSymbols; ++s) {
+                auto& w = out[s];
+                if (w.first != i) continue;     // chain already broken
+                const int count = isWild(static_cast<SymbolId>(s)) ? wilds : hist[s] + wilds;
+                if (count > 0) {
+                    ++w.first;
+                    w.second *= count;
+                }
+                else {
+                    --alive;
+                }
+            }
+        }
+        for (int s = 0; s < numSymbols; ++s) {
+            if (out[s].first == 0) out[s].second = 0;
+        }
+    }
+
    
     json toJson(bool includeOver = false, bool includeUnder = false) const {
         json screenJson;
@@ -256,8 +361,8 @@ public:
             json overJson = json::array();
             overJson.push_back("-");
             for (int i = 0; i < SIDE_LEN; ++i) {
-                const auto& c = overRow[i];
-                overJson.push_back(c.boosted ? (c.name + "*") : c.name);
+                const std::string name = symbolName(sideCell(true, i));
+                overJson.push_back(overBoosted[i] ? (name + "*") : name);
             }
             overJson.push_back("-");
             screenJson.push_back(overJson);
@@ -271,7 +376,7 @@ public:
 					rowJson.push_back("-"); // Might need to change spacing
 					//continue;
 				} else
-                rowJson.push_back(grid[j][i]);
+                rowJson.push_back(symbolName(cell(j, i)));
             }
             screenJson.push_back(rowJson);
         }
@@ -279,8 +384,8 @@ public:
             json underJson = json::array();
             underJson.push_back("-");
             for (int i = 0; i < SIDE_LEN; ++i) {
-                const auto& c = underRow[i];
-                underJson.push_back(c.boosted ? (c.name + "*") : c.name);
+                const std::string name = symbolName(sideCell(false, i));
+                underJson.push_back(underBoosted[i] ? (name + "*") : name);
             }
             underJson.push_back("-");
             screenJson.push_back(underJson);
@@ -289,54 +394,58 @@ public:
         return screenJson;
     }
 
-    void cascadeSideRow(bool over, ReelSet& rs, int boostProb)
-    {
-        auto& row = over ? overRow : underRow;
-        const auto& strip = rs.reels[0].symbols;
+    // Shift one side row left over its empty cells, refilling from `strip` starting at `left`
+    void shiftSideRow(bool over, const std::vector<SymbolId>& strip, int& left, bool forceBoost, int boostProb, MaskId boostMask) {
         const int N = static_cast<int>(strip.size());
         if (N == 0) return;
 
         // left = index for row[0]; next = symbol immediately AFTER the rightmost
-        int left = rs.currentIndices[0];
         int next = (left + SIDE_LEN) % N;      // <-- start AFTER the visible window
 
         for (int pos = 0; pos < SIDE_LEN; ++pos) {
-            while (row[pos].name.empty()) {
+            while (sideCell(over, pos) == EMPTY_SYMBOL) {
                 // shift visible window one step LEFT
-                for (int p = pos; p < SIDE_LEN - 1; ++p)
-                    row[p] = row[p + 1];
+                for (int p = pos; p < SIDE_LEN - 1; ++p) {
+                    sideCell(over, p) = sideCell(over, p + 1);
+                    sideBoost(over, p) = sideBoost(over, p + 1);
+                }
 
                 // bring the next symbol in on the RIGHT
-                //row[SIDE_LEN - 1] = strip[next];
-				bool boosted = getRand("TB", 100) < boostProb;
-                row[SIDE_LEN - 1] = SideCell{ strip[next], boosted }; 
+                bool boosted = forceBoost || (getRand(boostMask, 100) < boostProb);
+                setSideSymbol(over, SIDE_LEN - 1, strip[next], boosted);
 
                 // the window advanced by one:
                 left = (left + 1) % N;
                 next = (next + 1) % N;
             }
         }
-        rs.currentIndices[0] = left;           // <-- persist new leftmost index
     }
 
+    void cascadeSideRow(bool over, ReelCursor& rs, int boostProb)
+    {
+        static const MaskId maskTB = MaskRegistry::intern("TB");
+        shiftSideRow(over, rs.reel(0).ids, rs.currentIndices[0], false, boostProb, maskTB);  // <-- persists new leftmost index
+    }
 
 
-    void cascadeSymbols(ReelSet& reelSet, bool useDifferentReelSet, ReelSet& alternateReelSet) {
-        ReelSet& activeReelSet = useDifferentReelSet ? alternateReelSet : reelSet;
+
+    void cascadeSymbols(ReelCursor& reelSet, bool useDifferentReelSet, ReelCursor& alternateReelSet) {
+        ReelCursor& activeReelSet = useDifferentReelSet ? alternateReelSet : reelSet;
 
         for (int reel = 0; reel < numReels; ++reel) {
+            const auto& strip = activeReelSet.reel(reel).ids;
             for (int row = heights[reel] - 1; row >= 0; --row) {
-                while (grid[reel][row] == "") {
+                while (cell(reel, row) == EMPTY_SYMBOL) {
                     // Shift symbols above down to fill this empty position
                     for (int aboveRow = row; aboveRow > 0; aboveRow--) {
-                        grid[reel][aboveRow] = grid[reel][aboveRow - 1];
+                        cell(reel, aboveRow) = cell(reel, aboveRow - 1);
                     }
                     activeReelSet.currentIndices[reel]--;
                     if (activeReelSet.currentIndices[reel] < 0) {
-                        activeReelSet.currentIndices[reel] = activeReelSet.reels[reel].symbols.size() - 1;
+                        activeReelSet.currentIndices[reel] = static_cast<int>(strip.size()) - 1;
                     }
                     // Fill the topmost position with a new symbol
-                    grid[reel][0] = activeReelSet.reels[reel].symbols[activeReelSet.currentIndices[reel]];
+                    cell(reel, 0) = strip[activeReelSet.currentIndices[reel]];
                     
                 }
             }
@@ -345,12 +454,12 @@ public:
    
 
     // New method to add side symbols from an integrated ReelSet
-    void addSideSymbolsFromIntegratedReelSet(const ReelSet& rs,
+    void addSideSymbolsFromIntegratedReelSet(const ReelCursor& rs,
         const std::vector<bool>& overBoostVec = { 0,0,0,0 },
         const std::vector<bool>& underBoostVec = { 0,0,0,0 }) {
         // Add over symbols if the reelset has them
         if (rs.hasOverReel()) {
-            const auto& overStrip = rs.getOverReel()->symbols;
+            const auto& overStrip = rs.getOverReel()->ids;
             for (int i = 0; i < SIDE_LEN; ++i) {
                 setSideSymbol(true, i,
                     overStrip[(rs.currentOverIndex + i) % overStrip.size()],
@@ -360,7 +469,7 @@ public:
 
         // Add under symbols if the reelset has them
         if (rs.hasUnderReel()) {
-            const auto& underStrip = rs.getUnderReel()->symbols;
+            const auto& underStrip = rs.getUnderReel()->ids;
             for (int i = 0; i < SIDE_LEN; ++i) {
                 setSideSymbol(false, i,
                     underStrip[(rs.currentUnderIndex + i) % underStrip.size()],
@@ -370,61 +479,36 @@ public:
     }
 
     // Modified cascade method for integrated over/under reels
-    void cascadeSideRowIntegrated(bool over, ReelSet& rs, int boostProb) {
+    void cascadeSideRowIntegrated(bool over, ReelCursor& rs, int boostProb) {
         // Check if this reelset has the requested side reel
         if (over && !rs.hasOverReel()) return;
         if (!over && !rs.hasUnderReel()) return;
 
-        auto& row = over ? overRow : underRow;
-        const auto& strip = over ? rs.getOverReel()->symbols : rs.getUnderReel()->symbols;
-        const int N = static_cast<int>(strip.size());
-        if (N == 0) return;
-
-        // Get current index
+        static const MaskId maskBoostOver = MaskRegistry::intern("BoostT_O");
+        static const MaskId maskBoostUnder = MaskRegistry::intern("BoostT_U");
+        const auto& strip = over ? rs.getOverReel()->ids : rs.getUnderReel()->ids;
         int& currentIndex = over ? rs.currentOverIndex : rs.currentUnderIndex;
-
-        // left = index for row[0]; next = symbol immediately AFTER the rightmost
-        int left = currentIndex;
-        int next = (left + SIDE_LEN) % N;      // <-- start AFTER the visible window
-
-        for (int pos = 0; pos < SIDE_LEN; ++pos) {
-            while (row[pos].name.empty()) {
-                // shift visible window one step LEFT
-                for (int p = pos; p < SIDE_LEN - 1; ++p)
-                    row[p] = row[p + 1];
-
-                // bring the next symbol in on the RIGHT
-                //bool boosted = getRand("TB_" + (over) ? "O" : "U", 100) < boostProb;
-                bool boosted = (boostProb == 100) ||
-                               ( getRand(std::string("BoostT_") + (over ? "O" : "U"), 100) < boostProb );
-                row[SIDE_LEN - 1] = SideCell{ strip[next], boosted };
-
-                // the window advanced by one:
-                left = (left + 1) % N;
-                next = (next + 1) % N;
-            }
-        }
-        currentIndex = left;           // <-- persist new leftmost index
+        shiftSideRow(over, strip, currentIndex, boostProb == 100, boostProb, over ? maskBoostOver : maskBoostUnder);
     }
 
     // Alternative: Keep your existing addSideSymbols method for backward compatibility
     // and add an overload for integrated reelsets:
-    void addSideSymbols(bool over, const ReelSet& rs, const std::vector<bool>& boostVec = { 0,0,0,0 }) {
+    void addSideSymbols(bool over, const ReelCursor& rs, const std::vector<bool>& boostVec = { 0,0,0,0 }) {
         // Check if this is an integrated reelset with over/under reels
         if (over && rs.hasOverReel()) {
-            const auto& strip = rs.getOverReel()->symbols;
+            const auto& strip = rs.getOverReel()->ids;
             for (int i = 0; i < SIDE_LEN; ++i)
                 setSideSymbol(over, i, strip[(rs.currentOverIndex + i) % strip.size()], boostVec[i]);
         }
         else if (!over && rs.hasUnderReel()) {
-            const auto& strip = rs.getUnderReel()->symbols;
+            const auto& strip = rs.getUnderReel()->ids;
             for (int i = 0; i < SIDE_LEN; ++i)
                 setSideSymbol(over, i, strip[(rs.currentUnderIndex + i) % strip.size()], boostVec[i]);
         }
         else {
             // Fallback to old behavior for backward compatibility
             // (assuming single reel in reels[0] contains the side symbols)
-            const auto& strip = rs.reels[0].symbols;
+            const auto& strip = rs.reel(0).ids;
             for (int i = 0; i < SIDE_LEN; ++i)
                 setSideSymbol(over, i, strip[(rs.currentIndices[0] + i) % strip.size()], boostVec[i]);
         }
@@ -444,17 +528,17 @@ public:
 	}
 
     // Mark given symbol up to length on the screen. includeWild as parameter
-    void markSymbol(const string& symbol, int length, bool includeWild = true) {        
+    void markSymbol(SymbolId symbol, int length, bool includeWild = true) {
         for (int i = 0; i < length; ++i) {
             for (int j = 0; j < heights[i]; ++j) {
-                if (grid[i][j] == symbol || (includeWild && grid[i][j] == "WL")) {
+                if (match(cell(i, j), symbol, includeWild)) {
                     markedPositions.push_back(make_pair(i, j));
                 }
             }
             if (middleReel(i)) {
-                if (getSideSymbol(true, i - 1) == symbol || (includeWild && getSideSymbol(true, i - 1) == "WL"))
+                if (match(sideCell(true, i - 1), symbol, includeWild))
                     markedPositions.emplace_back(i, -1);            // -1  = overRow
-                if (getSideSymbol(false, i - 1) == symbol || (includeWild && getSideSymbol(false, i - 1) == "WL"))
+                if (match(sideCell(false, i - 1), symbol, includeWild))
                     markedPositions.emplace_back(i, -2);    // underRow sentinel
             }
         }
@@ -465,23 +549,22 @@ public:
             int reel = position.first;
             int row = position.second;
             if (row >= 0 && row < heights[reel]) {
-                grid[reel][row] = "";  // Clear the winning symbol in the grid
+                cell(reel, row) = EMPTY_SYMBOL;  // Clear the winning symbol in the grid
             } else if (middleReel(reel)) {
                 if (row == -1) {
-                    overRow[reel - 1].name = ""; overRow[reel - 1].boosted = false; }
+                    setSideSymbol(true, reel - 1, EMPTY_SYMBOL, false); }
                 else if (row == -2) { 
-                    underRow[reel - 1].name = ""; underRow[reel - 1].boosted = false; }
+                    setSideSymbol(false, reel - 1, EMPTY_SYMBOL, false); }
             }
         }
     }
 
     // Function to fill all marked symbols with a specified symbol
-    void fillMarkedSymbols(const string& symbol) {
+    void fillMarkedSymbols(SymbolId symbol) {
         for (const auto& position : markedPositions) {
 			int reel = position.first;
 			int row = position.second;
-			grid[reel][row] = symbol;
+			cell(reel, row) = symbol;
 		}
 	}
-};
-
+};
\ No newline at end of file
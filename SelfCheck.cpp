@@ -0,0 +1,239 @@
+// SelfCheck.cpp  —  build checks for the simulator, kept out of the production binary (C++14)
+//
+// Its own executable because it replaces the global operator new (AllocationCounter.h);
+// the simulator itself keeps the standard allocator. Also runs every match-mask kernel the
+// CPU supports against the scalar ways evaluator, and checks the exact engine against the
+// screen-by-screen enumeration and a Monte Carlo run of the initial screen.
+//
+//   SelfCheck [--model PATH] [--seed S] [--first-spin N] [--no-pay-histograms]
+//             [--check-allocations N] [--check-kernels N] [--check-exact N] [--exact-max-screens N]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+
+#include "RandomUtils.h"
+#include "Stats.h"
+#include "GameConfig.h"
+#include "GameInstance.h"
+#include "GameModelFile.h"
+#include "SymbolKernels.h"
+#include "ExactEngine.h"
+#include "AllocationCounter.h"
+
+// Globals the game headers expect; main.cpp defines them for the simulator
+LogMode        logMode = NO_LOGGING;
+SimulationMode simulationMode = RANDOM_MODE;
+uint64_t       rngMasterSeed = 42;
+
+namespace CheckDefaults {
+    constexpr long long ALLOCATION_SPINS = 100'000; // warm-up spins, then as many measured spins
+    constexpr long long KERNEL_SCREENS = 100'000;
+    constexpr long long EXACT_SPINS = 1'000'000;      // Monte Carlo spins compared with the exact engine
+    constexpr unsigned long long EXACT_MAX_SCREENS = ExactEngine::DEFAULT_MAX_ENUMERATED_SCREENS;
+    constexpr double EXACT_TOLERANCE = 1e-9;          // relative, reel-by-reel vs enumeration
+    constexpr double EXACT_SIGMAS = 4.0;              // Monte Carlo mean within this many standard errors
+}
+
+// Plays `spins` warm-up spins, then `spins` more one call at a time with the allocation
+// counter armed. Returns non-zero if any measured spin touched the heap.
+static int checkSpinAllocations(const std::shared_ptr<const GameModel>& model, SymbolStructure& symbolStructure,
+                                long long spins, long long firstSpin, bool payHistograms) {
+    Stats stats(symbolStructure, model->payHeaders, static_cast<double>(model->cost));
+    stats.setSingleWriter(true);
+    stats.setTrackPayFrequencies(payHistograms);
+    GameInstance instance(model, stats);
+    instance.setSpinIndex(firstSpin);
+    instance.playBaseGame(spins);
+
+    long long allocatingSpins = 0, allocations = 0, firstAllocatingSpin = -1;
+    for (long long i = 0; i < spins; ++i) {
+        AllocationCounter::arm();
+        instance.playBaseGame(1);
+        const long long n = AllocationCounter::disarm();
+        if (n == 0) continue;
+        if (allocatingSpins++ == 0) firstAllocatingSpin = instance.getSpinIndex() - 1;
+        allocations += n;
+    }
+
+    std::cout << "Allocation check: " << spins << " warm-up spins, " << spins << " measured spins\n";
+    if (allocatingSpins == 0) {
+        std::cout << "PASS: no heap allocations in the spin loop\n";
+        return 0;
+    }
+    std::cout << "FAIL: " << allocatingSpins << " spins made " << allocations
+              << " allocations (first at spin " << firstAllocatingSpin << ")\n";
+    return 1;
+}
+
+// Fills `screens` random screens of the model's reel count (random heights, side rows and holes
+// included) and evaluates each with every match-mask kernel this CPU can run. Returns non-zero
+// if any kernel disagrees with getWaysForAllSymbolsScalar.
+static int checkKernels(const std::shared_ptr<const GameModel>& model, long long screens) {
+    using namespace SymbolKernels;
+    std::vector<MatchMaskFn> kernels{ &matchMasksScalar };
+#ifdef SYMBOL_KERNELS_X86
+    kernels.push_back(&matchMasksSSE2);
+    if (cpuSupportsAVX2()) kernels.push_back(&matchMasksAVX2);
+#endif
+
+    const int numSymbols = static_cast<int>(model->symbols.size());
+    const int numReels = model->numReels;
+    Philox4x32 gen(rngMasterSeed, 0);
+    auto drawCell = [&]() -> SymbolId {
+        const uint32_t s = boundedRand(gen, numSymbols + 1);   // one extra outcome for a hole
+        return s == static_cast<uint32_t>(numSymbols) ? EMPTY_SYMBOL : static_cast<SymbolId>(s);
+    };
+
+    Screen screen;
+    screen.setSymbolStructure(&model->symbolStructure);
+    std::vector<long long> mismatches(kernels.size(), 0);
+    long long firstMismatch = -1;
+    for (long long n = 0; n < screens; ++n) {
+        int heights[MAX_REELS];
+        for (int r = 0; r < numReels; ++r) heights[r] = 1 + static_cast<int>(boundedRand(gen, MAX_ROWS));
+        screen.resize(heights, numReels);
+        for (int r = 0; r < numReels; ++r) {
+            for (int row = 0; row < heights[r]; ++row) screen.updateCell(r, row, drawCell());
+        }
+        for (int i = 0; i < Screen::SIDE_LEN; ++i) {
+            screen.setSideSymbol(true, i, drawCell());
+            screen.setSideSymbol(false, i, drawCell());
+        }
+
+        WaysTable expected, actual;
+        screen.getWaysForAllSymbolsScalar(numSymbols, expected);
+        for (size_t k = 0; k < kernels.size(); ++k) {
+            screen.getWaysForAllSymbols(numSymbols, actual, kernels[k]);
+            if (std::equal(expected.begin(), expected.begin() + numSymbols, actual.begin())) continue;
+            ++mismatches[k];
+            if (firstMismatch < 0) firstMismatch = n;
+        }
+    }
+
+    std::cout << "Kernel check: " << screens << " random screens, " << numReels << " reels, "
+              << numSymbols << " symbols\n";
+    int failures = 0;
+    for (size_t k = 0; k < kernels.size(); ++k) {
+        std::cout << "  " << kernelName(kernels[k]) << ": ";
+        if (mismatches[k] == 0) {
+            std::cout << "PASS\n";
+            continue;
+        }
+        std::cout << "FAIL on " << mismatches[k] << " screens\n";
+        ++failures;
+    }
+#ifdef SYMBOL_KERNELS_X86
+    if (!cpuSupportsAVX2()) std::cout << "  AVX2: skipped, not supported by this CPU\n";
+#endif
+    if (firstMismatch >= 0) std::cout << "First mismatch on screen " << firstMismatch << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+// Summary of the base game's initial screen over the selected reel sets
+struct ExactSummary {
+    double mean = 0.0, meanSq = 0.0, hit = 0.0, maxPay = 0.0;
+
+    explicit ExactSummary(const std::vector<ExactCycleResult>& results) {
+        for (const auto& r : results) {
+            mean += r.selectionProbability * r.meanPay();
+            meanSq += r.selectionProbability * r.meanPaySq();
+            hit += r.selectionProbability * r.hitFrequency();
+            maxPay = std::max(maxPay, r.maxPay);
+        }
+    }
+};
+
+static bool closeTo(double a, double b) {
+    return std::fabs(a - b) <= CheckDefaults::EXACT_TOLERANCE * std::max({ 1.0, std::fabs(a), std::fabs(b) });
+}
+
+// Evaluates the initial screen reel by reel, then compares it with the screen-by-screen
+// enumeration (when every cycle is within maxScreens) and with the Initial pay of `spins`
+// simulated spins. Returns non-zero on any disagreement.
+static int checkExact(const std::shared_ptr<const GameModel>& model, SymbolStructure& symbolStructure,
+                      long long spins, long long firstSpin, unsigned long long maxScreens) {
+    ExactEngine engine(model);
+    engine.setMaxEnumeratedScreens(maxScreens);
+    const ExactSummary exact(engine.run(1));
+    const double stdev = std::sqrt(std::max(0.0, exact.meanSq - exact.mean * exact.mean));
+    std::cout << "Exact check: mean " << exact.mean << ", stdev " << stdev << ", hit " << exact.hit
+              << ", max " << exact.maxPay << "\n";
+
+    int failures = 0;
+    try {
+        const ExactSummary enumerated(engine.enumerate(1));
+        const bool same = closeTo(exact.mean, enumerated.mean) && closeTo(exact.meanSq, enumerated.meanSq) &&
+                          closeTo(exact.hit, enumerated.hit) && closeTo(exact.maxPay, enumerated.maxPay);
+        std::cout << "  enumeration: mean " << enumerated.mean << ", meanSq " << enumerated.meanSq << ", hit "
+                  << enumerated.hit << ", max " << enumerated.maxPay << (same ? ": PASS\n" : ": FAIL\n");
+        if (!same) ++failures;
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "  enumeration: skipped, " << e.what() << "\n";
+    }
+
+    Stats stats(symbolStructure, model->payHeaders, static_cast<double>(model->cost));
+    stats.setTrackPayFrequencies(false);
+    GameInstance instance(model, stats);
+    instance.setSpinIndex(firstSpin);
+    instance.playBaseGame(spins);
+    const MomentAccumulator& initial = stats.getPayMoments().front();   // the Initial pay header
+    const double standardError = stdev / std::sqrt(static_cast<double>(initial.count()));
+    const bool agrees = std::fabs(initial.getMean() - exact.mean) <= CheckDefaults::EXACT_SIGMAS * standardError;
+    std::cout << "  Monte Carlo (" << spins << " spins): mean " << initial.getMean() << " +/- " << standardError
+              << ", stdev " << initial.standardDeviation() << (agrees ? ": PASS\n" : ": FAIL\n");
+    if (!agrees) ++failures;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::string modelPath;
+    long long firstSpin = 0;
+    bool payHistograms = true;
+    long long allocationSpins = CheckDefaults::ALLOCATION_SPINS;
+    long long kernelScreens = CheckDefaults::KERNEL_SCREENS;
+    long long exactSpins = CheckDefaults::EXACT_SPINS;
+    unsigned long long exactMaxScreens = CheckDefaults::EXACT_MAX_SCREENS;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--model" && i + 1 < argc) modelPath = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) rngMasterSeed = std::stoull(argv[++i]);
+        else if (arg == "--first-spin" && i + 1 < argc) firstSpin = std::stoll(argv[++i]);
+        else if (arg == "--no-pay-histograms") payHistograms = false;
+        else if (arg == "--check-allocations" && i + 1 < argc) allocationSpins = std::stoll(argv[++i]);
+        else if (arg == "--check-kernels" && i + 1 < argc) kernelScreens = std::stoll(argv[++i]);
+        else if (arg == "--check-exact" && i + 1 < argc) exactSpins = std::stoll(argv[++i]);
+        else if (arg == "--exact-max-screens" && i + 1 < argc) exactMaxScreens = std::stoull(argv[++i]);
+        else {
+            std::cerr << "Unknown argument " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::shared_ptr<const GameModel> model;
+    try {
+        if (!modelPath.empty()) {
+            model = GameModelFile::load(modelPath);
+        }
+        else {
+            GameConfig config("config.json");
+            model = std::make_shared<const GameModel>(config);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to load " << (modelPath.empty() ? "config.json" : modelPath) << ": " << e.what() << "\n";
+        return 1;
+    }
+    SymbolStructure symbolStructure = model->symbolStructure;
+
+    int failures = 0;
+    if (allocationSpins > 0) failures += checkSpinAllocations(model, symbolStructure, allocationSpins, firstSpin, payHistograms);
+    if (kernelScreens > 0) failures += checkKernels(model, kernelScreens);
+    if (exactSpins > 0) failures += checkExact(model, symbolStructure, exactSpins, firstSpin, exactMaxScreens);
+    return failures == 0 ? 0 : 1;
+}
@@ -1,10 +1,13 @@
 #pragma once
 #include "GameConfig.h" // Include GameConfig to access configuration data
+#include "PayHistogram.h"
+#include "MomentAccumulator.h"
 #include <vector>
 #include <algorithm>
 #include <fstream>
 #include <cmath> // Include for std::sqrt
 #include <unordered_map>
+#include <map>
 #include <mutex>
 #include <string>
 #include <iomanip>
@@ -22,23 +25,36 @@ namespace std {
 	};
 }
 
+// Index of a registered feature counter in Stats
+using FeatureId = int;
+
 class Stats {
 private:
         std::mutex statsMutex;
+        bool singleWriter = false; // owned by one thread: mutators skip statsMutex
         std::function<void(const Stats&, std::ostream&)> gameSpecificWriter_;
 
 	long long numIterations;
 	long long baseGameHits = 0;
+	long long hitSpins = 0; // spins with a non-zero total pay
 	double costPerSpin;
 	double totalWin;
 	std::vector<std::string> rtpHeaders;
 	std::vector<double> payVector, lastPay;
-	std::vector<std::unordered_map<double, long long>> payFrequencies;
-	std::unordered_map<std::string, long long> featureHits;
+	std::vector<PayHistogram> payFrequencies; // per RTP header, pays in whole credits
+	static constexpr size_t PAY_OVERFLOW_RESERVE = 1024; // distinct pays above the dense range before a histogram reallocates
+	std::vector<MomentAccumulator> payMoments; // per RTP header
+	bool trackPayFrequencies = true; // off: moments only, no histograms or pay_frequency files
+	// Features are registered once and then counted by index; names are only needed for the report
+	std::vector<std::string> featureNames;
+	std::vector<long long> featureHits;                 // per FeatureId
+	std::unordered_map<std::string, FeatureId> featureIds;
 	std::vector<std::vector<long long>> baseSymHits;
 	std::vector<std::vector<double>> baseSymPays;
-	std::unordered_map<int, long long> scatterHits, freeSpinsFreq, tumbleFreq, multFreq, multFreqFree;
-	std::unordered_map<int, std::unordered_map<int, long long>> multFreqFreeByInit;
+	// Integer-valued frequency tables, their dense arrays allocated by the constructor so
+	// counting a value seen for the first time does not allocate
+	PayHistogram scatterHits, freeSpinsFreq, tumbleFreq, multFreq, multFreqFree;
+	std::map<int, PayHistogram> multFreqFreeByInit;
 	SymbolStructure& symbolStructure;
 	std::vector<double> standardDeviations;
 	int totalWins = 0;
@@ -47,16 +63,19 @@ private:
 
         std::unordered_map<std::pair<int, int>, long long, std::hash<std::pair<int, int>>> scaleFrequency;
 
-        template <typename Map, typename Key>
-        void incrementCounter(Map& container, const Key& key) {
-                std::lock_guard<std::mutex> lock(statsMutex);
-                ++container[key];
+        FeatureId registerFeatureLocked(const std::string& featureName) {
+                auto it = featureIds.find(featureName);
+                if (it != featureIds.end()) return it->second;
+                const FeatureId id = static_cast<FeatureId>(featureNames.size());
+                featureIds.emplace(featureName, id);
+                featureNames.push_back(featureName);
+                featureHits.push_back(0);
+                return id;
         }
 
-        template <typename Map, typename OuterKey, typename InnerKey>
-        void incrementNestedCounter(Map& container, const OuterKey& outer, const InnerKey& inner) {
-                std::lock_guard<std::mutex> lock(statsMutex);
-                ++container[outer][inner];
+        // Lock for a mutating call; an unlocked (empty) lock in single-writer mode
+        std::unique_lock<std::mutex> writeLock() {
+                return singleWriter ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(statsMutex);
         }
 
         void writeDefaultStats(std::ostream& file) const {
@@ -70,6 +89,15 @@ private:
                 }
                 file << "----------------------------------------\n";
 
+                file << "Pay Moments\n";
+                file << "Name\tMean\tStDev\tSkewness\tExcess Kurtosis\tMax\n";
+                for (size_t i = 0; i < rtpHeaders.size(); ++i) {
+                        const MomentAccumulator& m = payMoments[i];
+                        file << rtpHeaders[i] << '\t' << std::setprecision(6) << m.getMean() << '\t' << m.standardDeviation()
+                                << '\t' << m.skewness() << '\t' << m.kurtosis() << '\t' << m.getMax() << '\n';
+                }
+                file << "----------------------------------------\n";
+
                 file << "Iterations\t" << numIterations << '\n';
                 file << "Total Pay\t" << payVector[3] << '\n';
 
@@ -77,9 +105,12 @@ private:
 
                 file << "Feature\tHits\tHit Rate\n";
 
-                std::vector<std::pair<std::string, long long>> sortedFeatures(featureHits.begin(), featureHits.end());
+                std::vector<std::pair<std::string, long long>> sortedFeatures;
+                for (size_t id = 0; id < featureHits.size(); ++id) {
+                        if (featureHits[id]) sortedFeatures.emplace_back(featureNames[id], featureHits[id]);
+                }
 
-                std::sort(sortedFeatures.begin(), sortedFeatures.end(),
+                std::stable_sort(sortedFeatures.begin(), sortedFeatures.end(),
                         [](const auto& a, const auto& b) {
                                 return a.second > b.second;
                         });
@@ -131,48 +162,32 @@ private:
                 file << "----------------------------------------\n";
                 file << "Tumble Frequencies\n";
                 file << "Number Tumble\tFrequency\n";
-                for (const auto& pair : tumbleFreq) {
-                        file << pair.first << '\t' << pair.second << '\n';
-                }
+                tumbleFreq.forEach([&](long long value, long long count) { file << value << '\t' << count << '\n'; });
                 file << "----------------------------------------\n";
 
                 file << "Average Final Multiplier: " << '\t' << calculateAverageFrequency(multFreq) << '\n';
                 file << "Final Multiplier Frequencies\n";
                 file << "Multiplier\tFrequency\n";
-                for (const auto& pair : multFreq) {
-                        file << pair.first << '\t' << pair.second << '\n';
-                }
+                multFreq.forEach([&](long long value, long long count) { file << value << '\t' << count << '\n'; });
                 file << "----------------------------------------\n";
                 file << "Average Final Multiplier Free Spins: " << '\t' << calculateAverageFrequency(multFreqFree) << '\n';
                 file << "Final Multiplier Frequencies Free Spins\n";
                 file << "Multiplier\tFrequency\n";
-                for (const auto& pair : multFreqFree) {
-                        file << pair.first << '\t' << pair.second << '\n';
-                }
+                multFreqFree.forEach([&](long long value, long long count) { file << value << '\t' << count << '\n'; });
                 file << "----------------------------------------\n";
                 file << "Final Multiplier Frequencies Free Spins (split by initial multiplier)\n";
 
-                std::vector<int> initKeys;
-                initKeys.reserve(multFreqFreeByInit.size());
-                for (const auto& kv : multFreqFreeByInit) initKeys.push_back(kv.first);
-                std::sort(initKeys.begin(), initKeys.end());
-
-                for (int init : initKeys) {
-                        const auto& freq = multFreqFreeByInit.at(init);
+                for (const auto& kv : multFreqFreeByInit) {
+                        const int init = kv.first;
+                        const PayHistogram& freq = kv.second;
 
-                        double avg = calculateAverageFrequency(const_cast<std::unordered_map<int, long long>&>(freq));
+                        double avg = calculateAverageFrequency(freq);
 
                         file << "Init Multiplier: " << init << "\n";
                         file << "Average Final Multiplier (init " << init << "):\t" << avg << "\n";
                         file << "Final Mult\tFrequency\n";
 
-                        std::vector<std::pair<int, long long>> rows(freq.begin(), freq.end());
-                        std::sort(rows.begin(), rows.end(),
-                                [](auto& a, auto& b) { return a.first < b.first; });
-
-                        for (const auto& p : rows) {
-                                file << p.first << '\t' << p.second << '\n';
-                        }
+                        freq.forEach([&](long long value, long long count) { file << value << '\t' << count << '\n'; });
                         file << "----------------------------------------\n";
                 }
 
@@ -191,6 +206,10 @@ public:
 		size_t numRTPs = rtpHeaders.size();
 		payVector.resize(numRTPs, 0.0);
 		payFrequencies.resize(numRTPs);
+		payMoments.resize(numRTPs);
+		for (PayHistogram* table : { &scatterHits, &freeSpinsFreq, &tumbleFreq, &multFreq, &multFreqFree }) {
+			table->allocateDense();
+		}
 
 		// featureHits.resize(featureNames.size(), 0);
 
@@ -199,6 +218,39 @@ public:
 		baseSymHits.resize(numSymbols, std::vector<long long>(maxLength, 0));
 		baseSymPays.resize(numSymbols, std::vector<double>(maxLength, 0.0));
 	}
+        // Histograms give the pay_frequency files; without them StDev comes from the
+        // streaming moments, which is enough for RTP/volatility runs. Enabling them sizes the
+        // histograms up front so the spin loop does not allocate; Stats that never call this
+        // allocate theirs on first use.
+        void setTrackPayFrequencies(bool enabled) {
+                trackPayFrequencies = enabled;
+                if (!enabled) return;
+                for (auto& hist : payFrequencies) {
+                        hist.allocateDense();
+                        hist.reserveOverflow(PAY_OVERFLOW_RESERVE);
+                }
+        }
+
+        const std::vector<MomentAccumulator>& getPayMoments() const {
+                return payMoments;
+        }
+
+        // Summed pay per RTP header; whole credits, so exact and independent of the merge order
+        const std::vector<double>& getPayTotals() const {
+                return payVector;
+        }
+
+        long long getHitSpins() const {
+                return hitSpins;
+        }
+
+        // Per-thread Stats written only by their worker accumulate without any locking;
+        // the owner must not share the object until the worker has finished (aggregate
+        // reads it after the join).
+        void setSingleWriter(bool enabled) {
+                singleWriter = enabled;
+        }
+
         // Set a custom writer for game-specific reporting (optional).
         void setGameSpecificWriter(std::function<void(const Stats&, std::ostream&)> fn) {
                 gameSpecificWriter_ = std::move(fn);
@@ -217,43 +269,56 @@ public:
         }
 
 	void setNumIterations(long long iterations) {
-		std::lock_guard<std::mutex> lock(statsMutex);
+		auto lock = writeLock();
 		numIterations = iterations;
 	}
 
+	void trackResult(SymbolId symbol, int length, int ways, double pay, bool base) {
+		if (!base) return;
+		auto lock = writeLock();
+		baseSymHits[symbol][length - 1] += ways;
+		baseSymPays[symbol][length - 1] += pay;
+	}
+
+	// By name, for callers outside the evaluators; a linear search per call
 	void trackResult(const std::string& symbol, int length, int ways, double pay, bool base) {
-		std::lock_guard<std::mutex> lock(statsMutex);
-		int symbolIndex = symbolStructure.findSymbolIndex(symbol);
-		int lengthIndex = length - 1;
-		if (base) {
-			baseSymHits[symbolIndex][lengthIndex] += ways;
-			baseSymPays[symbolIndex][lengthIndex] += pay;
-		}
+		trackResult(symbolStructure.getSymbolId(symbol), length, ways, pay, base);
 	}
 
         void recordScatterHit(int prize) {
-                incrementCounter(scatterHits, prize);
+                auto lock = writeLock();
+                scatterHits.addCredits(prize);
         }
 
         void recordTumbleFrequency(int tumbles) {
-                incrementCounter(tumbleFreq, tumbles);
+                auto lock = writeLock();
+                tumbleFreq.addCredits(tumbles);
         }
 
         void recordFinalMult(int mult) {
-                incrementCounter(multFreq, mult);
+                auto lock = writeLock();
+                multFreq.addCredits(mult);
         }
 
         void recordFinalMultFree(int mult) {
-                incrementCounter(multFreqFree, mult);
+                auto lock = writeLock();
+                multFreqFree.addCredits(mult);
         }
 
         void recordFinalMultFreeByInit(int initMult, int finalMult) {
-                incrementNestedCounter(multFreqFreeByInit, initMult, finalMult);
+                auto lock = writeLock();
+                auto it = multFreqFreeByInit.find(initMult);
+                if (it == multFreqFreeByInit.end()) {
+                        it = multFreqFreeByInit.emplace(initMult, PayHistogram()).first;
+                        it->second.allocateDense();
+                }
+                it->second.addCredits(finalMult);
         }
 
         //record number of free spins
         void recordFreeSpins(int freeSpins) {
-                incrementCounter(freeSpinsFreq, freeSpins);
+                auto lock = writeLock();
+                freeSpinsFreq.addCredits(freeSpins);
         }
 
 	//double calculateAverageTumbleFrequency() const {
@@ -269,13 +334,13 @@ public:
 	//	return static_cast<double>(totalTumbles) / totalOccurrences;
 	//}
 
-        double calculateAverageFrequency(const std::unordered_map<int, long long>& freqMap) const {
+        double calculateAverageFrequency(const PayHistogram& freq) const {
                 long long totalHits = 0;
                 long long totalOccurrences = 0;
-                for (const auto& pair : freqMap) {
-                        totalHits += pair.first * pair.second;
-                        totalOccurrences += pair.second;
-		}
+                freq.forEach([&](long long value, long long count) {
+                        totalHits += value * count;
+                        totalOccurrences += count;
+                });
 		if (totalOccurrences == 0) {
 			return 0.0;
 		}
@@ -296,28 +361,37 @@ public:
 	}*/
 
 	void completeWager(const std::vector<double>& pays) {
-		std::lock_guard<std::mutex> lock(statsMutex);
+		auto lock = writeLock();
 		for (size_t i = 0; i < pays.size(); i++) {
 			payVector[i] += pays[i];
-			payFrequencies[i][pays[i]]++;
+			if (trackPayFrequencies) payFrequencies[i].add(pays[i]);
+			payMoments[i].add(pays[i]);
 		}
 		if (pays[0] > 0) {
 			baseGameHits++;
 		}
+		if (pays.back() > 0) {
+			hitSpins++;
+		}
 		lastPay = pays;
 	}
 
-	//void trackFeatureActivation(const std::string& featureName) {
-	//    std::lock_guard<std::mutex> lock(statsMutex);
-	//    auto it = std::find(featureNames.begin(), featureNames.end(), featureName);
-	//    if (it != featureNames.end()) {
-	//        size_t index = std::distance(featureNames.begin(), it);
-	//        featureHits[index]++;
-	//    }
-	//}
+        // Handle for a feature counter; registering a name again returns the same handle.
+        // Register before the spin loop so a hit is a single increment.
+        FeatureId registerFeature(const std::string& featureName) {
+                auto lock = writeLock();
+                return registerFeatureLocked(featureName);
+        }
+
+        void trackFeatureActivation(FeatureId id) {
+                auto lock = writeLock();
+                ++featureHits[id];
+        }
 
+        // Convenience for occasional callers; looks the name up on every call
         void trackFeatureActivation(const std::string& featureName) {
-                incrementCounter(featureHits, featureName);
+                auto lock = writeLock();
+                ++featureHits[registerFeatureLocked(featureName)];
         }
 
 	double calculateStandardDeviation(const std::vector<double>& pays) const {
@@ -337,22 +411,8 @@ public:
 		standardDeviations.resize(payFrequencies.size(), 0.0);
 
 		for (size_t i = 0; i < payFrequencies.size(); ++i) {
-			double mean = 0.0;
-			double variance = 0.0;
-			double totalWeight = 0.0;
-
-			for (const auto& pair : payFrequencies[i]) {
-				mean += pair.first * pair.second;
-				totalWeight += pair.second;
-			}
-			mean /= totalWeight;
-
-			for (const auto& pair : payFrequencies[i]) {
-				variance += pair.second * std::pow(pair.first - mean, 2);
-			}
-			variance /= totalWeight;
-
-			standardDeviations[i] = std::sqrt(variance);
+			standardDeviations[i] = trackPayFrequencies ? payFrequencies[i].standardDeviation()
+				: payMoments[i].standardDeviation();
 		}
 	}
 
@@ -362,17 +422,19 @@ public:
 		numIterations += other.numIterations;
 		totalWin += other.totalWin;
 		baseGameHits += other.baseGameHits;
+		hitSpins += other.hitSpins;
 
 		for (size_t i = 0; i < payVector.size(); ++i) {
 			payVector[i] += other.payVector[i];
-			for (const auto& freqPair : other.payFrequencies[i]) {
-				payFrequencies[i][freqPair.first] += freqPair.second;
-			}
+			payFrequencies[i].merge(other.payFrequencies[i]);
+			payMoments[i].merge(other.payMoments[i]);
 		}
 
-		// Aggregate featureHits
-		for (const auto& pair : other.featureHits) {
-			featureHits[pair.first] += pair.second;
+		// Aggregate featureHits; instances that registered the same features in the same
+		// order (every GameInstance does) line up index for index
+		for (size_t id = 0; id < other.featureHits.size(); ++id) {
+			const bool sameId = id < featureNames.size() && featureNames[id] == other.featureNames[id];
+			featureHits[sameId ? static_cast<FeatureId>(id) : registerFeatureLocked(other.featureNames[id])] += other.featureHits[id];
 		}
 
 		for (size_t i = 0; i < baseSymHits.size(); ++i) {
@@ -382,30 +444,14 @@ public:
 			}
 		}
 
-		for (const auto& pair : other.scatterHits) {
-			scatterHits[pair.first] += pair.second;
-		}
-
-		for (const auto& pair : other.tumbleFreq) {
-			tumbleFreq[pair.first] += pair.second;
-		}
-
-		for (const auto& pair : other.multFreq) {
-			multFreq[pair.first] += pair.second;
-		}
-		for (const auto& pair : other.multFreqFree) {
-			multFreqFree[pair.first] += pair.second;
-		}
+		scatterHits.merge(other.scatterHits);
+		tumbleFreq.merge(other.tumbleFreq);
+		multFreq.merge(other.multFreq);
+		multFreqFree.merge(other.multFreqFree);
 		for (const auto& outerPair : other.multFreqFreeByInit) {
-			int initMult = outerPair.first;
-			for (const auto& innerPair : outerPair.second) {
-				multFreqFreeByInit[initMult][innerPair.first] += innerPair.second;
-			}
-		}
-
-		for (const auto& pair : other.freeSpinsFreq) {
-			freeSpinsFreq[pair.first] += pair.second;
+			multFreqFreeByInit[outerPair.first].merge(outerPair.second);
 		}
+		freeSpinsFreq.merge(other.freeSpinsFreq);
 
 		for (const auto& pair : other.scaleFrequency) {
 			scaleFrequency[pair.first] += pair.second;
@@ -424,7 +470,7 @@ public:
 	}
 
 	void recordWin(double amount) {
-		std::lock_guard<std::mutex> lock(statsMutex);
+		auto lock = writeLock();
 		totalWins++;
 		totalWinnings += amount;
 	}
@@ -441,34 +487,36 @@ public:
                 outputGameSpecificStats(gameSpecificFile);
         }
 
-	void printFrequencyTableToFile(const std::string& categoryName, const std::unordered_map<double, long long>& frequencyMap) const {
-		std::string filename = "pay_frequency_" + categoryName + ".txt";
+	static void printHistogramToFile(const std::string& filename, const std::string& valueLabel, const PayHistogram& histogram) {
 		std::ofstream file(filename);
 		if (!file.is_open()) {
 			std::cerr << "Failed to open " << filename << std::endl;
 			return;
 		}
 
-		std::vector<std::pair<double, long long>> freqVector(frequencyMap.begin(), frequencyMap.end());
-		std::sort(freqVector.begin(), freqVector.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
-
-		file << "Pay\tFrequency\n";
-		for (const auto& pair : freqVector) {
-			file << pair.first << "\t" << pair.second << "\n";
-		}
+		file << valueLabel << "\tFrequency\n";
+		histogram.forEach([&](long long value, long long count) {
+			file << static_cast<double>(value) << "\t" << count << "\n";
+		});
 
 		file.close();
 	}
 
-	void printFrequencyTables() const {
+	void printFrequencyTableToFile(const std::string& categoryName, const PayHistogram& frequencyMap,
+	                               const std::string& filePrefix = "") const {
+		printHistogramToFile(filePrefix + "pay_frequency_" + categoryName + ".txt", "Pay", frequencyMap);
+	}
+
+	// One pay_frequency file per pay header; runs writing several Stats set filePrefix apart
+	void printFrequencyTables(const std::string& filePrefix = "") const {
+		if (!trackPayFrequencies) return;
 		for (size_t i = 0; i < payFrequencies.size(); ++i) {
-			printFrequencyTableToFile(rtpHeaders[i], payFrequencies[i]);
+			printFrequencyTableToFile(rtpHeaders[i], payFrequencies[i], filePrefix);
 		}
 	}
 
 	int getTumbleCount() const {
-		return std::accumulate(tumbleFreq.begin(), tumbleFreq.end(), 0,
-			[](int sum, const auto& pair) { return sum + pair.second; });
+		return static_cast<int>(tumbleFreq.totalCount());
 	}
 
         double getFreeSpinPayout() const {
@@ -480,7 +528,7 @@ public:
 
 
 	void trackMoneyEntry(double amount) {
-		std::lock_guard<std::mutex> lock(statsMutex);
+		auto lock = writeLock();
 		moneyEntry.first++;
 		moneyEntry.second += amount;
 	}
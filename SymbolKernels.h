@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include "Symbols.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SYMBOL_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SYMBOL_KERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SYMBOL_KERNELS_AVX2_TARGET
+#endif
+
+// Match-mask kernels over the Screen's 64-byte cell block: masks[s] gets bit c set when
+// cells[c] == s, for every symbol id s < numSymbols. Per-reel counts are then a popcount of
+// the mask restricted to the reel's cells. The SIMD versions are picked once at runtime and use
+// unaligned loads, since heap-allocated screens are not guaranteed their 64-byte alignment.
+namespace SymbolKernels {
+
+    static constexpr int CELL_BLOCK = 64;
+
+    using MatchMaskFn = void (*)(const SymbolId* cells, int numSymbols, uint64_t* masks);
+
+    inline int popcount64(uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(m);
+#else
+        m = m - ((m >> 1) & 0x5555555555555555ULL);
+        m = (m & 0x3333333333333333ULL) + ((m >> 2) & 0x3333333333333333ULL);
+        m = (m + (m >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((m * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // Reference version, also the fallback on CPUs without SSE2/AVX2
+    inline void matchMasksScalar(const SymbolId* cells, int numSymbols, uint64_t* masks) {
+        for (int s = 0; s < numSymbols; ++s) masks[s] = 0;
+        for (int c = 0; c < CELL_BLOCK; ++c) {
+            if (cells[c] < numSymbols) masks[cells[c]] |= 1ULL << c;
+        }
+    }
+
+#ifdef SYMBOL_KERNELS_X86
+    inline void matchMasksSSE2(const SymbolId* cells, int numSymbols, uint64_t* masks) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(cells);
+        const __m128i c0 = _mm_loadu_si128(p), c1 = _mm_loadu_si128(p + 1);
+        const __m128i c2 = _mm_loadu_si128(p + 2), c3 = _mm_loadu_si128(p + 3);
+        for (int s = 0; s < numSymbols; ++s) {
+            const __m128i v = _mm_set1_epi8(static_cast<char>(s));
+            const uint64_t m0 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c0, v)));
+            const uint64_t m1 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c1, v)));
+            const uint64_t m2 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c2, v)));
+            const uint64_t m3 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c3, v)));
+            masks[s] = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+        }
+    }
+
+    SYMBOL_KERNELS_AVX2_TARGET
+    inline void matchMasksAVX2(const SymbolId* cells, int numSymbols, uint64_t* masks) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(cells);
+        const __m256i lo = _mm256_loadu_si256(p), hi = _mm256_loadu_si256(p + 1);
+        for (int s = 0; s < numSymbols; ++s) {
+            const __m256i v = _mm256_set1_epi8(static_cast<char>(s));
+            const uint64_t mLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v)));
+            const uint64_t mHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v)));
+            masks[s] = mLo | (mHi << 32);
+        }
+    }
+
+    inline bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;   // OS saves the YMM registers
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    inline const char* kernelName(MatchMaskFn fn) {
+#ifdef SYMBOL_KERNELS_X86
+        if (fn == &matchMasksAVX2) return "AVX2";
+        if (fn == &matchMasksSSE2) return "SSE2";
+#endif
+        return "scalar";
+    }
+
+    // Best kernel for this CPU, detected on first use
+    inline MatchMaskFn matchMasks() {
+        static const MatchMaskFn fn = []() -> MatchMaskFn {
+#ifdef SYMBOL_KERNELS_X86
+            if (cpuSupportsAVX2()) return &matchMasksAVX2;
+            return &matchMasksSSE2;     // baseline on x86-64 and on our 32-bit builds
+#else
+            return &matchMasksScalar;
+#endif
+        }();
+        return fn;
+    }
+}
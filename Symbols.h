@@ -2,12 +2,24 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <iostream>
 #include <numeric>
+#include <algorithm>
 #include <unordered_map>
 #include <random>
+#include <stdexcept>
 #include "RandomUtils.h"
 
+// Compact symbol id used on screens and reel strips (index into SymbolStructure::getSymbols())
+using SymbolId = uint8_t;
+constexpr SymbolId EMPTY_SYMBOL = 0xFF; // removed / unfilled cell
+constexpr int MAX_SYMBOLS = 64;         // ids must fit the 64-bit wild mask
+
+// Screen capacity limits (fixed so a whole screen fits in one 64-byte block)
+constexpr int MAX_REELS = 6;
+constexpr int MAX_ROWS = 8;
+
 struct Symbol {
     std::string name;
     int counter;
@@ -26,6 +38,32 @@ private:
     std::map<std::string, std::vector<int>> paytable;
     std::vector<int> scatterPrizes;
     std::unordered_map<std::string, std::vector<std::string>> wildSubstitutions;
+    uint64_t wildMask = 0; // bit i set if symbol id i is a wild
+    // Flat pays: payTable[id * payStride + length], length 0..winLength (length 0 pays nothing)
+    std::vector<int> payTable;
+    int winLength = 0;
+    int payStride = 1;
+
+    void buildPayTable() {
+        winLength = 0;
+        for (const auto& row : paytable_vec) winLength = std::max(winLength, static_cast<int>(row.size()));
+        payStride = winLength + 1;
+        payTable.assign(paytable_vec.size() * payStride, 0);
+        for (size_t id = 0; id < paytable_vec.size(); ++id) {
+            for (size_t len = 0; len < paytable_vec[id].size(); ++len) {
+                payTable[id * payStride + len + 1] = paytable_vec[id][len];
+            }
+        }
+    }
+
+    void buildWildMask() {
+        if (symbols.size() > MAX_SYMBOLS) throw std::invalid_argument("Too many symbols (max 64)");
+        wildMask = 0;
+        for (const auto& item : wildSubstitutions) {
+            int id = findSymbolIndex(item.first);
+            if (id >= 0) wildMask |= (1ULL << id);
+        }
+    }
 
 public:
     SymbolStructure() = default;
@@ -36,6 +74,8 @@ public:
             paytable_vec.push_back(symbolPayouts[i]);
             paytable[symbolNames[i]] = symbolPayouts[i];
         }
+        buildWildMask();
+        buildPayTable();
     }
 
     SymbolStructure(const std::vector<std::string>& symbolNames,
@@ -45,6 +85,8 @@ public:
         for (size_t i = 0; i < symbolNames.size(); ++i) {
             paytable[symbolNames[i]] = symbolPayouts[i];
         }
+        buildWildMask();
+        buildPayTable();
     }
 
     // Check if a symbol is wild and get its substitutions
@@ -57,10 +99,14 @@ public:
     }
 
     const std::vector<std::string>& getSymbols() const { return symbols; }
+    const std::unordered_map<std::string, std::vector<std::string>>& getWildSubstitutionMap() const { return wildSubstitutions; }
     const std::vector< std::vector<int>>& getPaytableVec() const { return paytable_vec; }
     const std::map<std::string, std::vector<int>>& getPaytable() const { return paytable; }
     const std::vector<int>& getScatterPrizes() const { return scatterPrizes; }
 
+    // Pay for `length` of symbol `id` on one way/line; O(1), for the evaluators and Stats
+    int getPay(SymbolId id, int length) const { return payTable[id * payStride + length]; }
+
     // Additional functionality for SymbolStructure can go here
     // For example, a method to find a symbol by name and return its index or payouts
     int findSymbolIndex(const std::string& name) const {
@@ -70,6 +116,21 @@ public:
         return -1; // Symbol not found
     }
 
+    // Symbol id for a name; throws for names missing from the paytable
+    SymbolId getSymbolId(const std::string& name) const {
+        int index = findSymbolIndex(name);
+        if (index < 0) throw std::invalid_argument("Unknown symbol: " + name);
+        return static_cast<SymbolId>(index);
+    }
+
+    const std::string& getSymbolName(SymbolId id) const {
+        static const std::string empty;
+        return id < symbols.size() ? symbols[id] : empty;
+    }
+
+    uint64_t getWildMask() const { return wildMask; }
+    bool isWild(SymbolId id) const { return id < MAX_SYMBOLS && ((wildMask >> id) & 1ULL); }
+
     const std::vector<int>* findSymbolPayouts(const std::string& name) const {
         for (size_t i = 0; i < symbols.size(); ++i) {
             if (symbols[i] == name) return &paytable_vec[i];
@@ -82,54 +143,61 @@ public:
     }
 
     const int getWinLength() const {
-        return paytable_vec[0].size();
+        return winLength;
     }
 };
 
 struct Reel {
     std::vector<std::string> symbols;
+    std::vector<SymbolId> ids; // symbols as ids, filled by bindSymbols()
     std::vector<int> weights;
+    WeightTable stopTable; // precomputed stop sampler, only for weighted reels
 
     // Constructor to accept a vector of strings
     Reel(const std::vector<std::string>& _symbols, const std::vector<int>& _weights = {})
         : symbols(_symbols), weights(_weights) {
+        if (!weights.empty()) stopTable = WeightTable(weights);
     }
 
     bool isWeighted() const { return !weights.empty(); }
+
+    void bindSymbols(const SymbolStructure& ss) {
+        ids.clear();
+        ids.reserve(symbols.size());
+        for (const auto& s : symbols) ids.push_back(ss.getSymbolId(s));
+    }
 };
 
 class ReelSet {
 private:
-    std::string mask;
+    MaskId mask = -1;
 
     // Optional over/under reels
     std::unique_ptr<Reel> overReel;
     std::unique_ptr<Reel> underReel;
-    std::string overMask;
-    std::string underMask;
+    MaskId overMask = -1;
+    MaskId underMask = -1;
 
 public:
     std::vector<Reel> reels;
-    std::vector<int> currentIndices; // Store current indices
-    int currentOverIndex = 0;  // Store current over reel index
-    int currentUnderIndex = 0; // Store current under reel index
 
     // Constructor for backward compatibility (no over/under reels)
     ReelSet(const std::vector<Reel>& reels, const std::string& mask)
-        : reels(reels), mask(mask), currentIndices(reels.size(), 0) {
+        : reels(reels), mask(MaskRegistry::intern(mask)) {
     }
 
     // Constructor with optional over/under reels
     ReelSet(const std::vector<Reel>& reels, const std::string& mask,
         const Reel* overReel, const std::string& overMask,
         const Reel* underReel, const std::string& underMask)
-        : reels(reels), mask(mask), currentIndices(reels.size(), 0),
-        overMask(overMask), underMask(underMask) {
+        : reels(reels), mask(MaskRegistry::intern(mask)) {
         if (overReel) {
             this->overReel = std::make_unique<Reel>(*overReel);
+            this->overMask = MaskRegistry::intern(overMask);
         }
         if (underReel) {
             this->underReel = std::make_unique<Reel>(*underReel);
+            this->underMask = MaskRegistry::intern(underMask);
         }
     }
 
@@ -138,9 +206,8 @@ public:
 
     // Copy constructor
     ReelSet(const ReelSet& other)
-        : reels(other.reels), mask(other.mask), currentIndices(other.currentIndices),
-        overMask(other.overMask), underMask(other.underMask),
-        currentOverIndex(other.currentOverIndex), currentUnderIndex(other.currentUnderIndex) {
+        : reels(other.reels), mask(other.mask),
+        overMask(other.overMask), underMask(other.underMask) {
         if (other.overReel) {
             overReel = std::make_unique<Reel>(*other.overReel);
         }
@@ -154,11 +221,8 @@ public:
         if (this != &other) {
             reels = other.reels;
             mask = other.mask;
-            currentIndices = other.currentIndices;
             overMask = other.overMask;
             underMask = other.underMask;
-            currentOverIndex = other.currentOverIndex;
-            currentUnderIndex = other.currentUnderIndex;
 
             if (other.overReel) {
                 overReel = std::make_unique<Reel>(*other.overReel);
@@ -183,6 +247,13 @@ public:
     // Move assignment operator
     ReelSet& operator=(ReelSet&& other) noexcept = default;
 
+    // Resolve every strip symbol to its id (throws on symbols missing from the paytable)
+    void bindSymbols(const SymbolStructure& ss) {
+        for (auto& reel : reels) reel.bindSymbols(ss);
+        if (overReel) overReel->bindSymbols(ss);
+        if (underReel) underReel->bindSymbols(ss);
+    }
+
     // Check if this reelset has over/under reels
     bool hasOverReel() const { return overReel != nullptr; }
     bool hasUnderReel() const { return underReel != nullptr; }
@@ -195,51 +266,78 @@ public:
     int getCycle() const {
         int cycle = 1;
         for (const auto& reel : reels) {
-            cycle *= reel.isWeighted() ? std::accumulate(reel.weights.begin(), reel.weights.end(), 0) : reel.symbols.size();
+            cycle *= reel.isWeighted() ? reel.stopTable.getTotalWeight() : reel.symbols.size();
         }
         return cycle;
     }
 
+    MaskId getMask() const { return mask; }
+    MaskId getOverMask() const { return overMask; }
+    MaskId getUnderMask() const { return underMask; }
+};
+
+// Spin state over a shared, read-only ReelSet: the stop of every reel and of the side rows.
+// Copying a cursor never copies strips, so each spin and free spin just points at its set.
+class ReelCursor {
+private:
+    const ReelSet* reelSet = nullptr;
+
+public:
+    std::array<int, MAX_REELS> currentIndices{}; // Store current indices
+    int currentOverIndex = 0;  // Store current over reel index
+    int currentUnderIndex = 0; // Store current under reel index
+
+    ReelCursor() {}
+    explicit ReelCursor(const ReelSet& rs) : reelSet(&rs) {}
+
+    const ReelSet& getReelSet() const { return *reelSet; }
+    const Reel& reel(int reelIndex) const { return reelSet->reels[reelIndex]; }
+    int getNumReels() const { return static_cast<int>(reelSet->reels.size()); }
+
+    bool hasOverReel() const { return reelSet->hasOverReel(); }
+    bool hasUnderReel() const { return reelSet->hasUnderReel(); }
+    const Reel* getOverReel() const { return reelSet->getOverReel(); }
+    const Reel* getUnderReel() const { return reelSet->getUnderReel(); }
+
     // Spin reels method - now also spins over/under if they exist
     void spinReels() {
-        std::vector<int> chosenIndices;
-        for (int reelIndex = 0; reelIndex < reels.size(); ++reelIndex) {
-            int index;
-            if (reels[reelIndex].isWeighted()) {
+        const MaskId mask = reelSet->getMask();
+        for (int reelIndex = 0; reelIndex < getNumReels(); ++reelIndex) {
+            const Reel& r = reel(reelIndex);
+            if (r.isWeighted()) {
                 // Use weighted distribution
-                index = getRandFromDist(mask, reels[reelIndex].weights);
+                currentIndices[reelIndex] = r.stopTable.sample(mask);
             }
             else {
                 // Use uniform distribution
-                index = getRand(mask, reels[reelIndex].symbols.size());
+                currentIndices[reelIndex] = getRand(mask, r.symbols.size());
             }
-            chosenIndices.push_back(index);
         }
-        currentIndices = chosenIndices;
 
         // Spin over reel if it exists
-        if (overReel) {
+        if (const Reel* overReel = getOverReel()) {
             if (overReel->isWeighted()) {
-                currentOverIndex = getRandFromDist(overMask, overReel->weights);
+                currentOverIndex = overReel->stopTable.sample(reelSet->getOverMask());
             }
             else {
-                currentOverIndex = getRand(overMask, overReel->symbols.size());
+                currentOverIndex = getRand(reelSet->getOverMask(), overReel->symbols.size());
             }
         }
 
         // Spin under reel if it exists
-        if (underReel) {
+        if (const Reel* underReel = getUnderReel()) {
             if (underReel->isWeighted()) {
-                currentUnderIndex = getRandFromDist(underMask, underReel->weights);
+                currentUnderIndex = underReel->stopTable.sample(reelSet->getUnderMask());
             }
             else {
-                currentUnderIndex = getRand(underMask, underReel->symbols.size());
+                currentUnderIndex = getRand(reelSet->getUnderMask(), underReel->symbols.size());
             }
         }
     }
 
     // Get current symbol from over/under reels
     std::string getCurrentOverSymbol() const {
+        const Reel* overReel = getOverReel();
         if (overReel && currentOverIndex < overReel->symbols.size()) {
             return overReel->symbols[currentOverIndex];
         }
@@ -247,6 +345,7 @@ public:
     }
 
     std::string getCurrentUnderSymbol() const {
+        const Reel* underReel = getUnderReel();
         if (underReel && currentUnderIndex < underReel->symbols.size()) {
             return underReel->symbols[currentUnderIndex];
         }
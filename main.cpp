@@ -5,16 +5,22 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <atomic>
 #include <memory>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <random>
 
 #include "RandomUtils.h"   // for LogMode, SimulationMode, RandomLogGenerator (your existing file)
 #include "Stats.h"
 #include "GameConfig.h"
 #include "GameInstance.h"
+#include "ExactEngine.h"
+#include "GameModelFile.h"
+#include "RtpSweep.h"
+#include "ProgressChannel.h"
 
 // --------------------------------------------------------------------------------------
 // 1) Quick toggles you can edit per run (config.json remains for game-specific info only)
@@ -24,12 +30,20 @@ namespace SimDefaults {
     constexpr SimulationMode SIM_MODE = RANDOM_MODE;  // EXACT_MODE | RANDOM_MODE | PLAYER_MODE | CSV_MODE
     constexpr long long      SPINS = 1'000'000;    // total spins across all threads
     constexpr int            THREADS = 12;           // threads for RANDOM_MODE (forced to 1 if logging/replay)
+    constexpr uint64_t       SEED = 0;            // master RNG seed; 0 = draw one from std::random_device
+    constexpr long long      FIRST_SPIN = 0;      // global index of the first spin (re-run a shard of a long job)
+    constexpr bool           PAY_HISTOGRAMS = true; // false: StDev from streaming moments, no pay_frequency files
+    constexpr double         PROGRESS_SECONDS = 10.0; // RANDOM_MODE progress line to stderr every N s; 0 = off
+    constexpr double         TARGET_CI = 0.0;     // stop RANDOM_MODE once the Total RTP 95% CI half-width is below this; 0 = off
+    constexpr long long      MIN_SPINS_BEFORE_STOP = 1'000'000; // never stop early before this many spins
+    constexpr long long      BATCH_SPINS = 65'536; // RANDOM_MODE work unit handed to whichever thread is free
     constexpr bool           ALLOW_CLI_OVERRIDE = true; // --spins N --threads T --log X --mode X
 }
 
 // These globals exist in your codebase; keep definitions here.
 LogMode        logMode = SimDefaults::LOG_MODE;
 SimulationMode simulationMode = SimDefaults::SIM_MODE;
+uint64_t       rngMasterSeed = SimDefaults::SEED;
 
 // Small timer for wall-time measurement
 struct Timer {
@@ -41,48 +55,67 @@ struct Timer {
     }
 };
 
+// Outcome of one player session
+struct PlayerSession {
+    bool reachedTarget = false;
+    long long spins = 0;         // spins played before reaching the target or going broke
+    double peakBalance = 0.0;    // highest balance during the session, in currency units
+};
+
+// Plays one session on a GameInstance owned by the calling worker, which is reused across
+// sessions; only the RNG position changes between players.
 class PlayerSimulation {
 public:
     PlayerSimulation(int startingCredits,
                      int targetCredits,
-                     std::shared_ptr<GameConfig> cfg,
-                     SymbolStructure& symbolStructure,
-                     Stats& stats)
+                     GameInstance& instance,
+                     Stats& stats,
+                     int cost)
         : startingCredits_(startingCredits),
           targetCredits_(targetCredits),
-          config_(std::move(cfg)),
-          symbolStructure_(symbolStructure),
-          stats_(stats) {}
+          instance_(instance),
+          stats_(stats),
+          cost_(cost) {}
 
-    bool simulate() {
-        GameInstance instance(config_, symbolStructure_, stats_);
+    PlayerSession simulate(long long firstSpin) {
+        PlayerSession session;
+        instance_.reset();
+        instance_.setSpinIndex(firstSpin);
 
-        const double stakePerSpin = static_cast<double>(config_->getCost()) / 100.0;
+        const double stakePerSpin = static_cast<double>(cost_) / 100.0;
+        double balance = static_cast<double>(startingCredits_) / 100.0;
+        session.peakBalance = balance;
         if (stakePerSpin <= 0.0) {
-            return false;
+            return session;
         }
 
-        double balance = static_cast<double>(startingCredits_) / 100.0;
         const double target = static_cast<double>(targetCredits_) / 100.0;
 
         while (balance >= stakePerSpin && balance < target) {
-            instance.playBaseGame(1);
+            instance_.playBaseGame(1);
             const double spinWin = stats_.getLastSpinPayout() / 100.0;
             balance += spinWin - stakePerSpin;
+            ++session.spins;
+            if (balance > session.peakBalance) session.peakBalance = balance;
         }
 
-        return balance >= target;
+        session.reachedTarget = balance >= target;
+        return session;
     }
 
 private:
     int startingCredits_;
     int targetCredits_;
-    std::shared_ptr<GameConfig> config_;
-    SymbolStructure& symbolStructure_;
+    GameInstance& instance_;
     Stats& stats_;
+    int cost_;
 };
 
-static void applyCliOverrides(int argc, char** argv, long long& spins, int& threads, LogMode& lm, SimulationMode& sm) {
+static void applyCliOverrides(int argc, char** argv, long long& spins, int& threads, LogMode& lm, SimulationMode& sm,
+                              uint64_t& seed, long long& firstSpin, bool& payHistograms,
+                              double& progressSeconds, double& targetCi, long long& batchSpins,
+                              std::string& modelPath, std::string& compilePath,
+                              std::string& rtpVariants, bool& pairedVariants) {
     if (!SimDefaults::ALLOW_CLI_OVERRIDE) return;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -92,6 +125,36 @@ static void applyCliOverrides(int argc, char** argv, long long& spins, int& thre
         else if ((arg == "--threads" || arg == "-t") && i + 1 < argc) {
             threads = std::stoi(argv[++i]);
         }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--first-spin" && i + 1 < argc) {
+            firstSpin = std::stoll(argv[++i]);
+        }
+        else if (arg == "--progress" && i + 1 < argc) {
+            progressSeconds = std::stod(argv[++i]);
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batchSpins = std::max(1LL, std::stoll(argv[++i]));
+        }
+        else if (arg == "--target-ci" && i + 1 < argc) {
+            targetCi = std::stod(argv[++i]);
+        }
+        else if (arg == "--model" && i + 1 < argc) {
+            modelPath = argv[++i];
+        }
+        else if (arg == "--compile" && i + 1 < argc) {
+            compilePath = argv[++i];
+        }
+        else if (arg == "--rtp-variants" && i + 1 < argc) {
+            rtpVariants = argv[++i];
+        }
+        else if (arg == "--paired") {
+            pairedVariants = true;
+        }
+        else if (arg == "--no-pay-histograms") {
+            payHistograms = false;
+        }
         else if (arg == "--log" && i + 1 < argc) {
             std::string v = argv[++i];
             if (v == "NO_LOGGING") lm = NO_LOGGING;
@@ -104,31 +167,121 @@ static void applyCliOverrides(int argc, char** argv, long long& spins, int& thre
             if (v == "RANDOM_MODE") sm = RANDOM_MODE;
             else if (v == "PLAYER_MODE") sm = PLAYER_MODE;
             else if (v == "CSV_MODE")    sm = CSV_MODE;
+            else if (v == "EXACT_MODE")  sm = EXACT_MODE;
             else std::cerr << "Unknown --mode " << v << " (using default)\n";
         }
     }
 }
 
+// RANDOM_MODE over several RTP variants on one worker pool. Writes each variant's usual
+// output, game-specific and pay_frequency files, named by its RTP key, plus one
+// consolidated sweep report, with the paired differences from the first variant when
+// opt.paired is set.
+static int runRtpSweep(const std::shared_ptr<const GameModel>& model, const std::string& variantList,
+                       SymbolStructure& symbolStructure, const std::vector<std::string>& rtpHeads, double costPerSpin,
+                       const RtpSweep::Options& opt, const Timer& timer) {
+    std::vector<size_t> variants;
+    try {
+        variants = RtpSweep::parseVariantList(*model, variantList);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    RtpSweep sweep(model, variants, symbolStructure, rtpHeads, costPerSpin);
+    const auto results = sweep.run(opt);
+    const double elapsed = timer.stop();
+
+    auto writeFooter = [&](std::ostream& out) {
+        out << "\nSeed: " << rngMasterSeed << "  First spin: " << opt.firstSpin << '\n';
+        out << "Symbol kernel: " << SymbolKernels::kernelName(SymbolKernels::matchMasks()) << '\n';
+        out << "Elapsed time: " << std::fixed << std::setprecision(3) << elapsed << " s\n";
+    };
+
+    for (size_t v = 0; v < results.size(); ++v) {
+        const std::string variantName = model->gameName + "_RTP" + sweep.variantKey(v) + "_" + model->modeLabel;
+        std::ofstream out(variantName + "_output.txt");
+        if (!out) {
+            std::cerr << "Failed to open output file: " << variantName << "_output.txt\n";
+            return 1;
+        }
+        results[v]->outputData(out, variantName + "_gameSpecificStats.txt");
+        results[v]->printFrequencyTables(variantName + "_");
+        writeFooter(out);
+    }
+
+    const std::string sweepFileName = model->gameName + "_RTPsweep_" + model->modeLabel + "_output.txt";
+    std::ofstream out(sweepFileName);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << sweepFileName << "\n";
+        return 1;
+    }
+    sweep.writeReport(results, out);
+    writeFooter(out);
+    sweep.writeReport(results, std::cout);
+    return 0;
+}
+
 int main(int argc, char** argv) {
     Timer timer; timer.start();
 
-    // ------------------------
-    // 2) Read game config JSON
-    // ------------------------
-    std::shared_ptr<GameConfig> config;
+    // -------------------------------
+    // 1b) Resolve sim toggles
+    // -------------------------------
+    long long numberOfSpins = SimDefaults::SPINS;
+    int       numThreads = SimDefaults::THREADS;
+    long long firstSpin = SimDefaults::FIRST_SPIN;
+    bool      payHistograms = SimDefaults::PAY_HISTOGRAMS;
+    double    progressSeconds = SimDefaults::PROGRESS_SECONDS;
+    double    targetCi = SimDefaults::TARGET_CI;
+    long long batchSpins = SimDefaults::BATCH_SPINS;
+    std::string modelPath;      // --model: load a compiled model instead of config.json
+    std::string compilePath;    // --compile: write the compiled model of config.json and exit
+    std::string rtpVariants;    // --rtp-variants: RANDOM_MODE over these RTP keys ("all" or K1,K2,...)
+    bool pairedVariants = false; // --paired: common random numbers, differences from the first variant
+
+    // from code defaults; allow CLI overrides
+    logMode = SimDefaults::LOG_MODE;
+    simulationMode = SimDefaults::SIM_MODE;
+    rngMasterSeed = SimDefaults::SEED;
+    applyCliOverrides(argc, argv, numberOfSpins, numThreads, logMode, simulationMode, rngMasterSeed, firstSpin, payHistograms,
+                      progressSeconds, targetCi, batchSpins,
+                      modelPath, compilePath, rtpVariants, pairedVariants);
+    if (rngMasterSeed == 0) {
+        std::random_device rd;
+        rngMasterSeed = (static_cast<uint64_t>(rd()) << 32) | static_cast<uint64_t>(rd());
+    }
+
+    // ------------------------------------------------
+    // 2) Load the game model (config.json or compiled)
+    // ------------------------------------------------
+    std::shared_ptr<const GameModel> model;     // compiled once, shared by every GameInstance
     try {
-        config = std::make_shared<GameConfig>("config.json");
+        if (!modelPath.empty()) {
+            model = GameModelFile::load(modelPath);
+        }
+        else {
+            GameConfig config("config.json");
+            model = std::make_shared<const GameModel>(config);
+        }
+        for (const auto& warning : model->warnings) std::cerr << "Warning: " << warning << "\n";
+        if (!compilePath.empty()) {
+            GameModelFile::save(*model, compilePath);
+            std::cout << "Compiled model written to " << compilePath << "\n";
+            return 0;
+        }
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load config.json: " << e.what() << "\n";
+        std::cerr << "Failed to load " << (modelPath.empty() ? "config.json" : modelPath) << ": " << e.what() << "\n";
         return 1;
     }
 
     // Game metadata for output file naming
-    const auto gameInfo = config->getGameInfo(); // [gameName, RTP, modeLabel]
-    const auto& rtpHeads = config->getRTPHeaders();
-    SymbolStructure symbolStructure = config->parseSymbolStructure();
-    const double costPerSpin = static_cast<double>(config->getCost());
+    const auto gameInfo = model->getGameInfo(); // [gameName, RTP, modeLabel]
+    const auto& rtpHeads = model->payHeaders;
+    SymbolStructure symbolStructure = model->symbolStructure;
+    const double costPerSpin = static_cast<double>(model->cost);
 
     const std::string baseName = gameInfo[0] + "_RTP" + gameInfo[1] + "_" + gameInfo[2];
     const std::string outputFileName = baseName + "_output.txt";
@@ -136,16 +289,27 @@ int main(int argc, char** argv) {
     const std::string gameDetailsFileName = baseName + "_gameDetails.txt";
     const std::string gameSpecificStatsFileName = baseName + "_gameSpecificStats.txt";
 
-    // -------------------------------
-    // 3) Resolve sim toggles + output
-    // -------------------------------
-    long long numberOfSpins = SimDefaults::SPINS;
-    int       numThreads = SimDefaults::THREADS;
-
-    // from code defaults; allow CLI overrides
-    logMode = SimDefaults::LOG_MODE;
-    simulationMode = SimDefaults::SIM_MODE;
-    applyCliOverrides(argc, argv, numberOfSpins, numThreads, logMode, simulationMode);
+    if (pairedVariants && rtpVariants.empty()) {
+        std::cerr << "--paired compares RTP variants; give them with --rtp-variants\n";
+        return 1;
+    }
+    if (!rtpVariants.empty()) {
+        if (simulationMode != RANDOM_MODE || logMode != NO_LOGGING) {
+            std::cerr << "--rtp-variants runs RANDOM_MODE without logging\n";
+            return 1;
+        }
+        RtpSweep::Options opt;
+        opt.spins = numberOfSpins;
+        opt.firstSpin = firstSpin;
+        opt.batchSpins = batchSpins;
+        opt.threads = numThreads;
+        opt.payHistograms = payHistograms;
+        opt.progressSeconds = progressSeconds;
+        opt.targetCi = targetCi;
+        opt.minSpinsBeforeStop = SimDefaults::MIN_SPINS_BEFORE_STOP;
+        opt.paired = pairedVariants;
+        return runRtpSweep(model, rtpVariants, symbolStructure, rtpHeads, costPerSpin, opt, timer);
+    }
 
     // Logging init (forces single-thread if not NO_LOGGING)
     if (logMode != NO_LOGGING) numThreads = 1;
@@ -163,33 +327,79 @@ int main(int argc, char** argv) {
 
     // Single aggregated stats object
     Stats finalStats(symbolStructure, rtpHeads, costPerSpin);
+    finalStats.setTrackPayFrequencies(payHistograms);
 
     // ----------------------------------------------------
     // 4) Run the selected simulation mode (RANDOM_MODE now)
     // ----------------------------------------------------
     if (simulationMode == RANDOM_MODE) {
-        // Split spins across threads (integer divide; remainder goes to first thread)
-        const long long spinsPerThread = numberOfSpins / std::max(1, numThreads);
-        const long long remainder = numberOfSpins - spinsPerThread * std::max(1, numThreads);
+        // Spins are handed out in batches from a shared counter: batch b covers global spin
+        // indices [firstSpin + b * batchSpins, ...), whichever thread takes it. Every spin draws
+        // from its own RNG stream, so the aggregate is identical for any thread count and
+        // schedule, and a slow thread no longer holds up the whole job.
+        const long long numBatches = (numberOfSpins + batchSpins - 1) / batchSpins;
+        std::atomic<long long> nextBatch(0);
 
         std::vector<std::thread> workers;
         std::vector<std::shared_ptr<Stats>> perThreadStats;
         perThreadStats.reserve(std::max(1, numThreads));
 
-        for (int i = 0; i < std::max(1, numThreads); ++i) {
-            const long long spinsThisThread = spinsPerThread + (i == 0 ? remainder : 0);
+        // Workers publish running totals after every batch; the reporter thread merges them
+        ProgressChannel progress(std::max(1, numThreads), rtpHeads.size());
+        std::atomic<int> workersRunning(std::max(1, numThreads));
 
+        for (int i = 0; i < std::max(1, numThreads); ++i) {
             auto statsPtr = std::make_shared<Stats>(symbolStructure, rtpHeads, costPerSpin);
-            statsPtr->setNumIterations(spinsThisThread);
+            statsPtr->setSingleWriter(true); // only its worker writes until the join
+            statsPtr->setTrackPayFrequencies(payHistograms);
             perThreadStats.emplace_back(statsPtr);
 
-            workers.emplace_back([config, &symbolStructure, statsPtr, spinsThisThread]() {
-                GameInstance instance(config, symbolStructure, *statsPtr);
-                instance.playBaseGame(spinsThisThread);
+            workers.emplace_back([model, statsPtr, &nextBatch, numBatches, batchSpins,
+                                  numberOfSpins, firstSpin, &progress, &workersRunning, i]() {
+                GameInstance instance(model, *statsPtr);
+                long long played = 0;
+                long long batch;
+                while (!progress.stopRequested() && (batch = nextBatch.fetch_add(1)) < numBatches) {
+                    const long long begin = batch * batchSpins;
+                    const long long count = std::min(batchSpins, numberOfSpins - begin);
+                    instance.setSpinIndex(firstSpin + begin);
+                    instance.playBaseGame(count);
+                    played += count;
+                    progress.publish(i, played, statsPtr->getHitSpins(), statsPtr->getPayMoments());
+                }
+                statsPtr->setNumIterations(played);
+                --workersRunning;
+                });
+        }
+
+        // Progress lines to stderr, and the early stop once the Total RTP is precise enough
+        std::thread reporter;
+        if (progressSeconds > 0 || targetCi > 0) {
+            reporter = std::thread([&]() {
+                Timer runTimer; runTimer.start();
+                double nextReport = progressSeconds;
+                while (workersRunning.load() > 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    const double now = runTimer.stop();
+                    const ProgressSnapshot snap = progress.collect();
+                    const double halfWidth = 1.96 * snap.standardError(rtpHeads.size() - 1) / costPerSpin;
+                    const bool converged = targetCi > 0 && snap.spins >= SimDefaults::MIN_SPINS_BEFORE_STOP
+                        && halfWidth < targetCi;
+                    if ((progressSeconds > 0 && now >= nextReport) || (converged && !progress.stopRequested())) {
+                        std::cerr << ProgressChannel::format(snap, rtpHeads, costPerSpin, numberOfSpins, now) << std::endl;
+                        nextReport += progressSeconds;
+                    }
+                    if (converged && !progress.stopRequested()) {
+                        std::cerr << "[progress] Total RTP 95% CI half-width " << halfWidth
+                                  << " is below the target " << targetCi << ", stopping early" << std::endl;
+                        progress.requestStop();
+                    }
+                }
                 });
         }
 
         for (auto& th : workers) th.join();
+        if (reporter.joinable()) reporter.join();
 
         // Aggregate results
         for (const auto& s : perThreadStats) finalStats.aggregate(*s);
@@ -200,6 +410,18 @@ int main(int argc, char** argv) {
         finalStats.printFrequencyTables();
 
     }
+    else if (simulationMode == EXACT_MODE) {
+        // Exact base game initial screen, evaluated reel by reel; side-strip stops split across threads
+        ExactEngine engine(model);
+        for (const auto& name : engine.getBaseReelSetNames()) {
+            unsigned long long size;
+            std::cout << "Cycle " << name << ": "
+                << (engine.cycleSize(name, size) ? std::to_string(size) : std::string("> 2^64")) << " combinations\n";
+        }
+        const auto results = engine.run(std::max(1, numThreads));
+        engine.writeReport(results, out);
+        engine.writeReport(results, std::cout);
+    }
     else if (simulationMode == CSV_MODE) {
         std::string userGameVersion;
         std::cout << "Enter the game version : ";
@@ -224,8 +446,10 @@ int main(int argc, char** argv) {
         const double stakePerSpin = costPerSpin / 100.0;
 
         Stats csvStats(symbolStructure, rtpHeads, costPerSpin);
+        csvStats.setSingleWriter(true);
         csvStats.setNumIterations(spinsToRun);
-        GameInstance gameInstance(config, symbolStructure, csvStats);
+        GameInstance gameInstance(model, csvStats);
+        gameInstance.setSpinIndex(firstSpin);
 
         for (long long i = 0; i < spinsToRun; ++i) {
             gameInstance.playBaseGame(1);
@@ -261,26 +485,77 @@ int main(int argc, char** argv) {
         std::cout << "CSV simulation completed. Output file: " << csvFileName << std::endl;
     }
     else if (simulationMode == PLAYER_MODE) {
-        int numPlayers = 10000;
+        long long numPlayers = 10000;
         if (numberOfSpins != SimDefaults::SPINS) {
-            numPlayers = static_cast<int>(std::max(1LL, numberOfSpins));
+            numPlayers = std::max(1LL, numberOfSpins);
         }
 
         const int startingCredits = 2000;
         const int targetCredits = 4000;
-        int successfulPlayers = 0;
-
-        for (int i = 0; i < numPlayers; ++i) {
-            Stats stats(symbolStructure, rtpHeads, costPerSpin);
-            PlayerSimulation sim(startingCredits, targetCredits, config, symbolStructure, stats);
-            if (sim.simulate()) {
-                ++successfulPlayers;
-            }
+
+        // Players are taken from a shared counter by a pool of workers, each with one reusable
+        // GameInstance. Player i always starts at spin firstSpin + i * 2^32, so sessions never
+        // share an RNG stream and the results do not depend on the thread count.
+        struct PlayerTotals {
+            long long successfulPlayers = 0;
+            PayHistogram sessionLengths;    // spins per session
+            PayHistogram peakBalances;      // in credits
+            MomentAccumulator lengthMoments, peakMoments;
+        };
+        const int playerThreads = std::max(1, numThreads);
+        std::vector<PlayerTotals> totals(playerThreads);
+        std::atomic<long long> nextPlayer(0);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < playerThreads; ++t) {
+            workers.emplace_back([&, t]() {
+                Stats stats(symbolStructure, rtpHeads, costPerSpin);
+                stats.setSingleWriter(true);
+                stats.setTrackPayFrequencies(false);
+                GameInstance instance(model, stats);
+                PlayerSimulation sim(startingCredits, targetCredits, instance, stats, model->cost);
+                PlayerTotals& mine = totals[t];
+
+                long long player;
+                while ((player = nextPlayer.fetch_add(1)) < numPlayers) {
+                    const PlayerSession session = sim.simulate(firstSpin + (player << 32));
+                    if (session.reachedTarget) ++mine.successfulPlayers;
+                    mine.sessionLengths.addCredits(session.spins);
+                    mine.peakBalances.add(session.peakBalance * 100.0);
+                    mine.lengthMoments.add(static_cast<double>(session.spins));
+                    mine.peakMoments.add(session.peakBalance);
+                }
+                });
+        }
+        for (auto& th : workers) th.join();
+
+        PlayerTotals all;
+        for (const auto& part : totals) {
+            all.successfulPlayers += part.successfulPlayers;
+            all.sessionLengths.merge(part.sessionLengths);
+            all.peakBalances.merge(part.peakBalances);
+            all.lengthMoments.merge(part.lengthMoments);
+            all.peakMoments.merge(part.peakMoments);
         }
 
-        const double successPercentage = (static_cast<double>(successfulPlayers) / std::max(1, numPlayers)) * 100.0;
-        out << "Percentage of players reaching target credits: " << successPercentage << "%\n";
-        std::cout << "Percentage of players reaching target credits: " << successPercentage << "%\n";
+        const double successPercentage = (static_cast<double>(all.successfulPlayers) / numPlayers) * 100.0;
+        std::ostringstream report;
+        report << "Players\t" << numPlayers << '\n';
+        report << "Percentage of players reaching target credits: " << successPercentage << "%\n";
+        report << "----------------------------------------\n";
+        report << "Distribution\tMean\tStDev\tP10\tP50\tP90\tP99\tMax\n";
+        report << "Session Spins\t" << all.lengthMoments.getMean() << '\t' << all.lengthMoments.standardDeviation();
+        for (double q : { 0.10, 0.50, 0.90, 0.99 }) report << '\t' << all.sessionLengths.quantile(q);
+        report << '\t' << all.lengthMoments.getMax() << '\n';
+        report << "Peak Balance\t" << all.peakMoments.getMean() << '\t' << all.peakMoments.standardDeviation();
+        for (double q : { 0.10, 0.50, 0.90, 0.99 }) report << '\t' << all.peakBalances.quantile(q) / 100.0;
+        report << '\t' << all.peakMoments.getMax() << '\n';
+        report << "----------------------------------------\n";
+        out << report.str();
+        std::cout << report.str();
+
+        Stats::printHistogramToFile("player_session_spins.txt", "Spins", all.sessionLengths);
+        Stats::printHistogramToFile("player_peak_balance.txt", "Peak Credits", all.peakBalances);
     }
     else {
         std::cerr << "Unknown SimulationMode.\n";
@@ -294,7 +569,9 @@ int main(int argc, char** argv) {
     // 5) Footer + clean close
     // -----------------------
     const double elapsed = timer.stop();
-    out << "\nElapsed time: " << std::fixed << std::setprecision(3) << elapsed << " s\n";
+    out << "\nSeed: " << rngMasterSeed << "  First spin: " << firstSpin << '\n';
+    out << "Symbol kernel: " << SymbolKernels::kernelName(SymbolKernels::matchMasks()) << '\n';
+    out << "Elapsed time: " << std::fixed << std::setprecision(3) << elapsed << " s\n";
     out.close();
 
     RandomLogGenerator::closeLogs();